@@ -0,0 +1,168 @@
+/*
+ * A monitor (Section 6.7) as a reusable template: it owns the state it
+ * protects, so the state can only be reached with the monitor's lock held,
+ * and offers named condition queues with Mesa semantics.
+ */
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+
+//=============================================================================
+// MONITOR<T>
+//=============================================================================
+//
+// Everything happens inside an Access, which holds the monitor lock for as
+// long as it lives:
+//
+//     Monitor<State> monitor;
+//     auto& not_busy = monitor.condition("not busy");
+//     monitor.execute([&](Monitor<State>::Access& m) {
+//         m.wait(not_busy, [&] { return !m->busy; });
+//         m->busy = true;
+//     });
+//
+// Mesa semantics: a notified thread is only made runnable and has to win
+// the lock again, by which time the condition may be false again, so wait
+// always re-checks a predicate. notify_one/notify_all only wake threads on
+// the queue they name, skip the wakeup entirely when that queue is empty,
+// and are delivered when the Access releases the lock, so the woken thread
+// does not immediately block on a mutex its notifier still holds. (So a
+// woken thread must not destroy the monitor while another thread may still
+// be inside execute(); keep monitors alive until all their users are done.)
+
+template<typename T>
+class Monitor {
+public:
+    class Condition {
+    private:
+        friend class Monitor;
+        std::string name;
+        std::condition_variable cv;
+        int waiting = 0;   // guarded by the monitor lock
+
+    public:
+        explicit Condition(std::string n) : name(std::move(n)) {}
+        const std::string& getName() const { return name; }
+    };
+
+    class Access {
+    private:
+        static constexpr int MAX_DEFERRED = 8;
+
+        struct Deferred {
+            Condition* condition;
+            bool all;
+        };
+
+        Monitor& monitor;
+        std::unique_lock<std::mutex> lock;
+        Deferred deferred[MAX_DEFERRED];
+        int deferred_count = 0;
+
+        void notify(Condition& c, bool all) {
+            if (c.waiting == 0) return;   // nobody to wake: no system call
+            for (int i = 0; i < deferred_count; ++i) {
+                if (deferred[i].condition != &c) continue;
+                if (deferred[i].all) return;   // already waking everyone
+                if (all) {
+                    deferred[i].all = true;
+                    return;
+                }
+                break;   // a second notify_one needs an entry of its own
+            }
+            if (deferred_count == MAX_DEFERRED) {
+                // Out of room: notify now, still correct, just earlier.
+                if (all) c.cv.notify_all();
+                else c.cv.notify_one();
+                return;
+            }
+            deferred[deferred_count++] = {&c, all};
+        }
+
+        // Anything deferred must go out before this thread sleeps, or the
+        // threads it meant to wake might wait for it forever.
+        void flush() {
+            for (int i = 0; i < deferred_count; ++i) {
+                if (deferred[i].all) deferred[i].condition->cv.notify_all();
+                else deferred[i].condition->cv.notify_one();
+            }
+            deferred_count = 0;
+        }
+
+    public:
+        explicit Access(Monitor& m) : monitor(m), lock(m.mtx) {}
+        Access(const Access&) = delete;
+        Access& operator=(const Access&) = delete;
+
+        ~Access() {
+            lock.unlock();
+            flush();
+        }
+
+        T& operator*() { return monitor.state; }
+        T* operator->() { return &monitor.state; }
+
+        // Waits on c until pred() holds; pred is checked with the lock held.
+        template<typename Pred>
+        void wait(Condition& c, Pred pred) {
+            while (!pred()) wait(c);
+        }
+
+        // One wait on c. Returns after a notify or spuriously; the caller
+        // must re-check whatever it was waiting for.
+        void wait(Condition& c) {
+            flush();
+            c.waiting++;
+            c.cv.wait(lock);
+            c.waiting--;
+        }
+
+        void notify_one(Condition& c) { notify(c, false); }
+        void notify_all(Condition& c) { notify(c, true); }
+    };
+
+private:
+    std::mutex mtx;
+    T state;
+
+    // The queues have a lock of their own, so condition() can be called
+    // from inside execute() without the thread deadlocking against itself.
+    std::mutex conditions_mtx;
+    std::deque<Condition> conditions;   // a deque never moves its elements
+
+public:
+    template<typename... Args>
+    explicit Monitor(Args&&... args) : state(std::forward<Args>(args)...) {}
+
+    Monitor(const Monitor&) = delete;
+    Monitor& operator=(const Monitor&) = delete;
+
+    // The condition queue called name, created on first use. Safe with or
+    // without the monitor lock held. Look queues up once and keep the
+    // reference; this is not meant for the hot path.
+    Condition& condition(const std::string& name) {
+        std::lock_guard<std::mutex> guard(conditions_mtx);
+        for (Condition& c : conditions) {
+            if (c.name == name) return c;
+        }
+        conditions.emplace_back(name);
+        return conditions.back();
+    }
+
+    Access enter() { return Access(*this); }
+
+    // Runs fn(access) with the lock held and returns what fn returns.
+    template<typename Fn>
+    auto execute(Fn&& fn) -> decltype(fn(std::declval<Access&>())) {
+        Access access(*this);
+        return fn(access);
+    }
+};
+
+#endif // MONITOR_H
@@ -0,0 +1,197 @@
+/*
+ * Bounded multi-producer/multi-consumer queue without locks (Dmitry
+ * Vyukov's sequence-numbered ring), and a blocking wrapper around it that
+ * only sleeps when the queue is empty or full.
+ */
+
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "futex.h"
+
+//=============================================================================
+// LOCK-FREE BOUNDED MPMC QUEUE
+//=============================================================================
+//
+// Every slot carries a sequence number that says whose turn it is:
+//   sequence == pos          free for the producer that claims position pos
+//   sequence == pos + 1      holds the item for the consumer at position pos
+// A producer claims a position by CAS on enqueue_pos, writes the item and
+// then publishes it by storing pos + 1; a consumer claims by CAS on
+// dequeue_pos, reads, and hands the slot to the producer one lap later by
+// storing pos + capacity. Producers and consumers only meet on a slot, never
+// on a shared lock, and each slot and each position has its own cache line.
+//
+// T must be default-constructible and move-assignable.
+
+template<typename T>
+class MpmcQueue {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(CACHE_LINE) std::atomic<size_t> enqueue_pos{0};
+    alignas(CACHE_LINE) std::atomic<size_t> dequeue_pos{0};
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+public:
+    // The capacity is rounded up to a power of two (at least 2).
+    explicit MpmcQueue(size_t capacity)
+        : mask(roundUpPowerOfTwo(capacity) - 1), slots(new Slot[mask + 1]) {
+        for (size_t i = 0; i <= mask; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // Returns false if the queue is full, in which case item is left as it
+    // was (an rvalue is only moved from on success).
+    template<typename U>
+    bool try_push(U&& item) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            long long diff = (long long)seq - (long long)pos;
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.data = std::forward<U>(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // pos was reloaded by the failed CAS
+            } else if (diff < 0) {
+                return false;   // the slot still holds last lap's item
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false if the queue is empty.
+    bool try_pop(T& item) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            long long diff = (long long)seq - (long long)(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = std::move(slot.data);
+                    slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // nothing published here yet
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+//=============================================================================
+// BLOCKING WRAPPER
+//=============================================================================
+//
+// push and pop go straight to the lock-free queue and touch nothing else
+// unless they fail. Only then does a thread sleep, on a futex word (an
+// "event count") that the other side bumps after a successful operation.
+// The low bit of the word says someone is asleep or about to be, so only the
+// first push or pop after a thread parks pays for the wake system call;
+// while nobody sleeps, notify is a fence and a load.
+
+template<typename T>
+class BlockingMpmcQueue {
+private:
+    struct alignas(64) WaitPoint {
+        std::atomic<int> state{0};   // bit 0: sleepers; bits 1..: event number
+
+        // Sleeps until retry() succeeds. The sleeper bit is set before the
+        // final retry, so a notify that lands in between is never lost: it
+        // either happened before the retry (which then succeeds) or it sees
+        // the bit and moves the event number on, which stops futexWait.
+        template<typename Retry>
+        void waitUntil(Retry retry) {
+            while (true) {
+                int seen = state.fetch_or(1) | 1;
+                if (retry()) return;
+                futexWait(&state, seen);
+                if (retry()) return;
+            }
+        }
+
+        void notify() {
+            // Orders the caller's successful push/pop before the state
+            // check, pairing with the fetch_or in waitUntil.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int s = state.load(std::memory_order_relaxed);
+            while (s & 1) {
+                int next = (int)(((unsigned)s + 2u) & ~1u);
+                if (state.compare_exchange_weak(s, next)) {
+                    // Everyone wakes; those who lose the race set the bit again.
+                    futexWake(&state, INT_MAX);
+                    return;
+                }
+            }
+        }
+    };
+
+    MpmcQueue<T> queue;
+    WaitPoint not_empty;
+    WaitPoint not_full;
+
+public:
+    explicit BlockingMpmcQueue(size_t capacity) : queue(capacity) {}
+
+    void push(T item) {
+        if (!queue.try_push(std::move(item))) {
+            not_full.waitUntil([&] { return queue.try_push(std::move(item)); });
+        }
+        not_empty.notify();
+    }
+
+    T pop() {
+        T item;
+        if (!queue.try_pop(item)) {
+            not_empty.waitUntil([&] { return queue.try_pop(item); });
+        }
+        not_full.notify();
+        return item;
+    }
+
+    bool try_push(T item) {
+        if (!queue.try_push(std::move(item))) return false;
+        not_empty.notify();
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        if (!queue.try_pop(item)) return false;
+        not_full.notify();
+        return true;
+    }
+
+    size_t capacity() const { return queue.capacity(); }
+};
+
+#endif // MPMC_QUEUE_H
@@ -11,6 +11,21 @@
 #include <mutex>
 #include <condition_variable>
 #include <random>
+#include <shared_mutex>
+#include <algorithm>
+#include <iomanip>
+#include <functional>
+
+#include "sharded_counter.h"
+#include "futex_semaphore.h"
+#include "mpmc_queue.h"
+#include "spsc_ring.h"
+#include "spinlocks.h"
+#include "software_locks.h"
+#include "rw_locks.h"
+#include "seqlock.h"
+#include "rcu.h"
+#include "monitor.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -96,8 +111,12 @@ int RaceConditionDemo::shared_counter = 0;
 
 class PetersonSolution {
 private:
-    static bool flag[2];
-    static int turn;
+    // Atomics, not plain bool/int: with plain variables the compiler may
+    // keep them in registers and the CPU may let the load of flag[other]
+    // overtake the store to flag[me], and both threads get in. The default
+    // seq_cst ordering keeps every store ahead of the loads that follow it.
+    static atomic<bool> flag[2];
+    static atomic<int> turn;
     static int shared_data;
     static const int ITERATIONS = 1000;
     
@@ -144,10 +163,104 @@ public:
     }
 };
 
-bool PetersonSolution::flag[2] = {false, false};
-int PetersonSolution::turn = 0;
+atomic<bool> PetersonSolution::flag[2];
+atomic<int> PetersonSolution::turn{0};
 int PetersonSolution::shared_data = 0;
 
+//=============================================================================
+// 2b. SOFTWARE-ONLY MUTUAL EXCLUSION FOR N THREADS
+//=============================================================================
+
+class SoftwareLockCost {
+private:
+    static constexpr int ACQUISITIONS = 1000000;
+    static constexpr int RUN_MS = 200;
+
+    // Gives a Lockable the lock(id)/unlock(id) interface of the software
+    // locks so both kinds go through the same measurement.
+    template<typename L>
+    struct IgnoreId {
+        L inner;
+        explicit IgnoreId(int) {}
+        void lock(int) { inner.lock(); }
+        void unlock(int) { inner.unlock(); }
+    };
+
+    // Nanoseconds per lock/unlock pair by one thread of a lock sized for n.
+    template<typename Lock>
+    static double uncontended(int n) {
+        Lock lock(n);
+        auto start = steady_clock::now();
+        for (int i = 0; i < ACQUISITIONS; ++i) {
+            lock.lock(0);
+            lock.unlock(0);
+        }
+        return duration<double, nano>(steady_clock::now() - start).count() / ACQUISITIONS;
+    }
+
+    // Millions of acquisitions per second with n threads competing.
+    template<typename Lock>
+    static double contended(int n) {
+        Lock lock(n);
+        long long shared = 0;
+        atomic<long long> total{0};
+        atomic<bool> stop{false};
+        vector<thread> workers;
+        for (int id = 0; id < n; ++id) {
+            workers.emplace_back([&, id]() {
+                long long mine = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    lock.lock(id);
+                    shared++;
+                    lock.unlock(id);
+                    mine++;
+                }
+                total += mine;
+            });
+        }
+        this_thread::sleep_for(milliseconds(RUN_MS));
+        stop = true;
+        for (auto& w : workers) w.join();
+        if (shared != total) cout << "  (mutual exclusion broken!)" << endl;
+        return total / (RUN_MS * 1000.0);
+    }
+
+    template<typename Lock>
+    static void row(const char* name, const vector<int>& sizes, bool two_only = false) {
+        cout << left << setw(14) << name << right;
+        for (int n : sizes) {
+            if (two_only && n != 2) cout << setw(10) << "-";
+            else cout << setw(10) << uncontended<Lock>(n);
+        }
+        cout << setw(4) << "";
+        for (int n : {2, 4}) {
+            if (two_only && n != 2) cout << setw(10) << "-";
+            else cout << setw(10) << contended<Lock>(n);
+        }
+        cout << endl;
+    }
+
+public:
+    static void demonstrate_software_lock_cost() {
+        cout << "\n=== SOFTWARE-ONLY LOCKS VS HARDWARE INSTRUCTIONS ===" << endl;
+        vector<int> sizes = {2, 4, 8, 16};
+        cout << "Uncontended ns per lock/unlock for a lock sized for n threads;" << endl;
+        cout << "then millions of acquisitions per second with 2 and 4 threads competing" << endl;
+        cout << left << setw(14) << "n" << right;
+        for (int n : sizes) cout << setw(10) << n;
+        cout << setw(4) << "" << setw(10) << "2 thr" << setw(10) << "4 thr" << endl;
+
+        cout << fixed << setprecision(2);
+        row<PetersonLock>("Peterson", sizes, true);
+        row<FilterLock>("filter", sizes);
+        row<BakeryLock>("bakery", sizes);
+        row<IgnoreId<TasLock>>("TAS", sizes);
+        row<IgnoreId<TicketLock>>("ticket", sizes);
+        row<IgnoreId<McsLock>>("MCS", sizes);
+        row<IgnoreId<mutex>>("std::mutex", sizes);
+    }
+};
+
 //=============================================================================
 // 3. HARDWARE INSTRUCTIONS (Section 6.4)
 //=============================================================================
@@ -229,6 +342,86 @@ public:
 atomic<bool> HardwareInstructions::lock_var{false};
 int HardwareInstructions::shared_counter = 0;
 
+//=============================================================================
+// 3b. SPINLOCKS: BACKOFF, TICKETS AND QUEUES
+//=============================================================================
+
+class SpinlockComparison {
+private:
+    static constexpr int RUN_MS = 200;
+
+    struct Result {
+        double mops;       // millions of lock/unlock pairs per second
+        double fairness;   // fewest acquisitions of any thread / most
+    };
+
+    // Every thread takes the lock as often as it can for RUN_MS; a spinning
+    // waiter that preempts the holder only shows up once threads outnumber
+    // the CPUs.
+    template<typename Lock>
+    static Result measure(int threads) {
+        Lock lock;
+        long long shared = 0;
+        atomic<bool> stop{false};
+        vector<long long> acquired(threads, 0);
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                long long mine = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    lock_guard<Lock> guard(lock);
+                    shared++;
+                    mine++;
+                }
+                acquired[t] = mine;
+            });
+        }
+        this_thread::sleep_for(milliseconds(RUN_MS));
+        stop = true;
+        for (auto& w : workers) w.join();
+
+        long long total = 0, fewest = acquired[0], most = acquired[0];
+        for (long long n : acquired) {
+            total += n;
+            fewest = min(fewest, n);
+            most = max(most, n);
+        }
+        if (total != shared) cout << "  (mutual exclusion broken!)" << endl;
+        return {total / (RUN_MS * 1000.0), most ? (double)fewest / most : 1.0};
+    }
+
+    template<typename Lock>
+    static void row(const char* name, const vector<int>& thread_counts) {
+        cout << left << setw(14) << name << right;
+        for (int threads : thread_counts) {
+            Result r = measure<Lock>(threads);
+            cout << setw(8) << r.mops << setw(6) << r.fairness;
+        }
+        cout << endl;
+    }
+
+public:
+    static void demonstrate_spinlocks() {
+        cout << "\n=== SPINLOCK COMPARISON ===" << endl;
+        int cores = (int)thread::hardware_concurrency();
+        vector<int> thread_counts;
+        for (int threads = 1; threads <= max(8, 2 * cores); threads *= 2) thread_counts.push_back(threads);
+
+        cout << cores << " CPUs; per thread count: millions of acquisitions per second, "
+             << "then fairness (fewest / most per thread)" << endl;
+        cout << left << setw(14) << "threads" << right;
+        for (int threads : thread_counts) cout << setw(8) << threads << setw(6) << "";
+        cout << endl;
+
+        cout << fixed << setprecision(2);
+        row<mutex>("std::mutex", thread_counts);
+        row<TasLock>("TAS", thread_counts);
+        row<TtasLock>("TTAS+backoff", thread_counts);
+        row<TicketLock>("ticket", thread_counts);
+        row<McsLock>("MCS", thread_counts);
+    }
+};
+
 //=============================================================================
 // 4. MUTEX LOCKS (Section 6.5)
 //=============================================================================
@@ -267,6 +460,81 @@ public:
 mutex MutexDemo::mtx;
 int MutexDemo::shared_counter = 0;
 
+//=============================================================================
+// 4b. SCALING A SHARED COUNTER: MUTEX VS ATOMICS VS SHARDING
+//=============================================================================
+
+class CounterScaling {
+private:
+    static constexpr int ITERATIONS = 1000000;   // per thread
+
+    // Runs `increment` ITERATIONS times on each of `threads` threads and
+    // returns millions of increments per second.
+    static double measure(int threads, const function<void()>& increment) {
+        vector<thread> workers;
+        auto start = steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&increment]() {
+                for (int i = 0; i < ITERATIONS; ++i) increment();
+            });
+        }
+        for (auto& w : workers) w.join();
+        double secs = duration<double>(steady_clock::now() - start).count();
+        return threads * (double)ITERATIONS / secs / 1e6;
+    }
+
+public:
+    static void demonstrate_counter_scaling() {
+        cout << "\n=== COUNTER SCALING DEMONSTRATION ===" << endl;
+        int max_threads = max(4, (int)thread::hardware_concurrency());
+
+        mutex mtx;
+        long long locked_counter = 0;
+        atomic<long long> atomic_counter{0};
+        atomic<long long> cas_counter{0};
+        ShardedCounter sharded(max_threads);
+
+        // The same four increments as sections 3 and 4, plus the sharded one.
+        auto with_mutex = [&]() {
+            lock_guard<mutex> lock(mtx);
+            locked_counter++;
+        };
+        auto with_fetch_add = [&]() { atomic_counter.fetch_add(1); };
+        auto with_cas = [&]() {
+            long long old_val = cas_counter.load();
+            while (!cas_counter.compare_exchange_weak(old_val, old_val + 1)) {
+                // old_val now holds the current value; retry
+            }
+        };
+        auto with_shards = [&]() { sharded.add(1); };
+
+        cout << ITERATIONS << " increments per thread, millions of increments per second:" << endl;
+        cout << setw(8) << "threads" << setw(10) << "mutex" << setw(12) << "fetch_add"
+             << setw(10) << "CAS loop" << setw(10) << "sharded" << endl;
+
+        bool all_correct = true;
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            locked_counter = 0;
+            atomic_counter = 0;
+            cas_counter = 0;
+            sharded.reset();
+
+            double m = measure(threads, with_mutex);
+            double f = measure(threads, with_fetch_add);
+            double c = measure(threads, with_cas);
+            double s = measure(threads, with_shards);
+
+            long long expected = (long long)threads * ITERATIONS;
+            all_correct = all_correct && locked_counter == expected && atomic_counter == expected
+                          && cas_counter == expected && sharded.read() == expected;
+
+            cout << fixed << setprecision(1) << setw(8) << threads << setw(10) << m << setw(12) << f
+                 << setw(10) << c << setw(10) << s << endl;
+        }
+        cout << "All counters exact: " << (all_correct ? "SUCCESS" : "FAILED") << endl;
+    }
+};
+
 //=============================================================================
 // 5. SEMAPHORE IMPLEMENTATION (Section 6.6) - Using Custom Semaphore
 //=============================================================================
@@ -309,6 +577,96 @@ public:
 
 Semaphore SemaphoreDemo::resource_semaphore{3}; // 3 resources available
 
+//=============================================================================
+// 5b. FUTEX SEMAPHORE VS MUTEX + CONDITION VARIABLE SEMAPHORE
+//=============================================================================
+
+class SemaphoreComparison {
+private:
+    static constexpr int UNCONTENDED_OPS = 5000000;
+    static constexpr int CONTENDED_OPS = 200000;    // per thread
+    static constexpr int HANDOFFS = 100000;
+
+    // Nanoseconds per acquire + release pair from a single thread.
+    template<typename Sem>
+    static double uncontended() {
+        Sem sem(1);
+        auto start = steady_clock::now();
+        for (int i = 0; i < UNCONTENDED_OPS; ++i) {
+            sem.acquire();
+            sem.release();
+        }
+        return duration<double, nano>(steady_clock::now() - start).count() / UNCONTENDED_OPS;
+    }
+
+    // Millions of acquire + release pairs per second with `threads`
+    // threads sharing `permits` permits.
+    template<typename Sem>
+    static double contended(int threads, int permits) {
+        Sem sem(permits);
+        atomic<int> inside{0};
+        atomic<bool> overflow{false};
+        vector<thread> workers;
+        auto start = steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for (int i = 0; i < CONTENDED_OPS; ++i) {
+                    sem.acquire();
+                    if (inside.fetch_add(1) >= permits) overflow = true;
+                    inside.fetch_sub(1);
+                    sem.release();
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        if (overflow) cout << "  (more than " << permits << " threads inside!)" << endl;
+        double secs = duration<double>(steady_clock::now() - start).count();
+        return threads * (double)CONTENDED_OPS / secs / 1e6;
+    }
+
+    // Microseconds per round trip when two threads hand control back and
+    // forth, so every acquire has to sleep.
+    template<typename Sem>
+    static double pingPong() {
+        Sem ping(0), pong(0);
+        thread partner([&]() {
+            for (int i = 0; i < HANDOFFS; ++i) {
+                ping.acquire();
+                pong.release();
+            }
+        });
+        auto start = steady_clock::now();
+        for (int i = 0; i < HANDOFFS; ++i) {
+            ping.release();
+            pong.acquire();
+        }
+        partner.join();
+        return duration<double, micro>(steady_clock::now() - start).count() / HANDOFFS;
+    }
+
+public:
+    static void demonstrate_semaphore_comparison() {
+        cout << "\n=== FUTEX SEMAPHORE VS CONDITION VARIABLE SEMAPHORE ===" << endl;
+        cout << fixed << setprecision(1);
+        cout << "Uncontended acquire + release (ns):  condvar " << uncontended<Semaphore>()
+             << ", futex " << uncontended<FutexSemaphore>() << endl;
+        cout << "Ping-pong round trip (us):           condvar " << pingPong<Semaphore>()
+             << ", futex " << pingPong<FutexSemaphore>() << endl;
+
+        int max_threads = max(4, (int)thread::hardware_concurrency());
+        cout << "Contended, millions of acquire + release per second:" << endl;
+        cout << setw(8) << "threads" << setw(9) << "permits" << setw(10) << "condvar" << setw(9) << "futex" << endl;
+        for (int threads = 2; threads <= 2 * max_threads; threads *= 2) {
+            for (int permits : {1, threads / 2}) {
+                cout << setw(8) << threads << setw(9) << permits
+                     << setw(10) << contended<Semaphore>(threads, permits)
+                     << setw(9) << contended<FutexSemaphore>(threads, permits) << endl;
+                if (threads / 2 == 1) break;
+            }
+        }
+    }
+};
+
 //=============================================================================
 // 6. PRODUCER-CONSUMER PROBLEM (Sections 6.1, 6.6)
 //=============================================================================
@@ -405,58 +763,313 @@ condition_variable ProducerConsumer::not_full;
 bool ProducerConsumer::done = false;
 
 //=============================================================================
-// 7. MONITOR IMPLEMENTATION (Section 6.7)
+// 6b. BOUNDED BUFFER THROUGHPUT: MUTEX + CONDITIONS VS LOCK-FREE RING
 //=============================================================================
 
-class Monitor {
+// The ProducerConsumer buffer above as a reusable class: one mutex and two
+// condition variables around a circular array.
+template<typename T>
+class LockedBoundedBuffer {
 private:
-    mutable mutex monitor_mutex;
-    condition_variable condition_x;
-    int x_count = 0;
-    
+    vector<T> buffer;
+    size_t in = 0, out = 0, count = 0;
+    mutex buffer_mutex;
+    condition_variable not_empty, not_full;
+
 public:
-    void wait_x() {
-        unique_lock<mutex> lock(monitor_mutex);
-        x_count++;
-        condition_x.wait(lock);
-        x_count--;
+    explicit LockedBoundedBuffer(size_t capacity) : buffer(capacity) {}
+
+    void push(T item) {
+        unique_lock<mutex> lock(buffer_mutex);
+        not_full.wait(lock, [this] { return count < buffer.size(); });
+        buffer[in] = move(item);
+        in = (in + 1) % buffer.size();
+        count++;
+        lock.unlock();
+        not_empty.notify_one();
     }
-    
-    void signal_x() {
-        unique_lock<mutex> lock(monitor_mutex);
-        if (x_count > 0) {
-            condition_x.notify_one();
+
+    T pop() {
+        unique_lock<mutex> lock(buffer_mutex);
+        not_empty.wait(lock, [this] { return count > 0; });
+        T item = move(buffer[out]);
+        out = (out + 1) % buffer.size();
+        count--;
+        lock.unlock();
+        not_full.notify_one();
+        return item;
+    }
+};
+
+class QueueThroughput {
+private:
+    static constexpr long long ITEMS = 240000;   // divisible by 1 to 4 producers and consumers
+
+    // Millions of items per second through the queue; false in `ok` if
+    // any item was lost or duplicated.
+    template<typename Queue>
+    static double measure(int producers, int consumers, size_t capacity, bool& ok) {
+        Queue queue(capacity);
+        atomic<long long> consumed_sum{0};
+        vector<thread> threads;
+        auto start = steady_clock::now();
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, p, producers]() {
+                for (long long i = p; i < ITEMS; i += producers) queue.push(i);
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&queue, &consumed_sum, consumers]() {
+                long long sum = 0;
+                for (long long i = 0; i < ITEMS / consumers; ++i) sum += queue.pop();
+                consumed_sum += sum;
+            });
         }
+        for (auto& t : threads) t.join();
+        double secs = duration<double>(steady_clock::now() - start).count();
+        ok = ok && consumed_sum == ITEMS * (ITEMS - 1) / 2;
+        return ITEMS / secs / 1e6;
     }
-    
-    template<typename Func>
-    auto execute(Func&& func) -> decltype(func()) {
-        unique_lock<mutex> lock(monitor_mutex);
-        return func();
+
+public:
+    static void demonstrate_queue_throughput() {
+        cout << "\n=== BOUNDED BUFFER THROUGHPUT ===" << endl;
+        cout << ITEMS << " items, millions of items per second:" << endl;
+        cout << setw(10) << "producers" << setw(10) << "consumers" << setw(10) << "capacity"
+             << setw(13) << "mutex+cond" << setw(11) << "lock-free" << endl;
+
+        bool ok = true;
+        cout << fixed << setprecision(2);
+        for (size_t capacity : {16, 1024}) {
+            for (int producers : {1, 2, 4}) {
+                for (int consumers : {1, 2, 4}) {
+                    double locked = measure<LockedBoundedBuffer<long long>>(producers, consumers, capacity, ok);
+                    double lock_free = measure<BlockingMpmcQueue<long long>>(producers, consumers, capacity, ok);
+                    cout << setw(10) << producers << setw(10) << consumers << setw(10) << capacity
+                         << setw(13) << locked << setw(11) << lock_free << endl;
+                }
+            }
+        }
+        cout << "Every item delivered exactly once: " << (ok ? "SUCCESS" : "FAILED") << endl;
+    }
+};
+
+//=============================================================================
+// 6c. ONE PRODUCER, ONE CONSUMER: SPSC RING
+//=============================================================================
+
+class SpscThroughput {
+private:
+    static constexpr long long ITEMS = 4000000;
+    static constexpr size_t CAPACITY = 1024;
+    static constexpr size_t BATCH = 64;
+
+    // Nanoseconds per item from producer start to consumer finish, with the
+    // consumer checking the items arrive in order.
+    template<typename Produce, typename Consume>
+    static double measure(Produce produce, Consume consume, bool& ok) {
+        long long last = -1;
+        bool in_order = true;
+        auto start = steady_clock::now();
+        thread producer(produce);
+        consume([&](long long item) {
+            in_order = in_order && item == last + 1;
+            last = item;
+        });
+        producer.join();
+        double ns = duration<double, nano>(steady_clock::now() - start).count() / ITEMS;
+        ok = ok && in_order && last == ITEMS - 1;
+        return ns;
+    }
+
+    template<typename Queue>
+    static double blocking(bool& ok) {
+        Queue queue(CAPACITY);
+        return measure([&]() { for (long long i = 0; i < ITEMS; ++i) queue.push(i); },
+                       [&](auto check) { for (long long i = 0; i < ITEMS; ++i) check(queue.pop()); }, ok);
+    }
+
+    // The ring never blocks, so each side yields the CPU when it has to wait.
+    static double ringSingle(bool& ok) {
+        SpscRing<long long> ring(CAPACITY);
+        return measure(
+            [&]() {
+                for (long long i = 0; i < ITEMS; ++i) {
+                    while (!ring.try_push(i)) this_thread::yield();
+                }
+            },
+            [&](auto check) {
+                long long item;
+                for (long long i = 0; i < ITEMS; ++i) {
+                    while (!ring.try_pop(item)) this_thread::yield();
+                    check(item);
+                }
+            }, ok);
+    }
+
+    static double ringBatched(bool& ok) {
+        SpscRing<long long> ring(CAPACITY);
+        return measure(
+            [&]() {
+                long long batch[BATCH];
+                for (long long i = 0; i < ITEMS;) {
+                    size_t n = (size_t)min<long long>(BATCH, ITEMS - i);
+                    for (size_t k = 0; k < n; ++k) batch[k] = i + k;
+                    size_t sent = 0;
+                    while (sent < n) {
+                        size_t pushed = ring.push_batch(batch + sent, n - sent);
+                        if (!pushed) this_thread::yield();
+                        sent += pushed;
+                    }
+                    i += n;
+                }
+            },
+            [&](auto check) {
+                long long batch[BATCH];
+                for (long long received = 0; received < ITEMS;) {
+                    size_t n = ring.pop_batch(batch, BATCH);
+                    if (!n) this_thread::yield();
+                    for (size_t k = 0; k < n; ++k) check(batch[k]);
+                    received += n;
+                }
+            }, ok);
+    }
+
+public:
+    static void demonstrate_spsc_throughput() {
+        cout << "\n=== SINGLE PRODUCER / SINGLE CONSUMER THROUGHPUT ===" << endl;
+        cout << ITEMS << " items through a " << CAPACITY << "-slot buffer, nanoseconds per item:" << endl;
+
+        bool ok = true;
+        cout << fixed << setprecision(1);
+        cout << left << setw(28) << "mutex + conditions" << right << setw(8)
+             << blocking<LockedBoundedBuffer<long long>>(ok) << endl;
+        cout << left << setw(28) << "lock-free MPMC" << right << setw(8)
+             << blocking<BlockingMpmcQueue<long long>>(ok) << endl;
+        cout << left << setw(28) << "SPSC ring, one at a time" << right << setw(8) << ringSingle(ok) << endl;
+        cout << left << setw(28) << "SPSC ring, batches of 64" << right << setw(8) << ringBatched(ok) << endl;
+        cout << "Every item delivered once and in order: " << (ok ? "SUCCESS" : "FAILED") << endl;
+    }
+};
+
+//=============================================================================
+// 6d. READERS-WRITERS: READ-MOSTLY SHARED DATA
+//=============================================================================
+
+class ReadersWriters {
+private:
+    static constexpr int RUN_MS = 200;
+    static constexpr int FIELDS = 8;
+
+    // A writer bumps every field, so a reader that sees them differ has
+    // read in the middle of a write.
+    struct SharedRecord {
+        long long fields[FIELDS] = {};
+    };
+
+    // Exclusive lock for everyone, as every other demo in this file does.
+    struct ExclusiveOnly {
+        mutex mtx;
+        void lock() { mtx.lock(); }
+        void unlock() { mtx.unlock(); }
+        void lock_shared() { mtx.lock(); }
+        void unlock_shared() { mtx.unlock(); }
+    };
+
+    // Millions of operations per second when each operation is a write
+    // with probability write_percent / 100.
+    template<typename RwLock>
+    static double measure(int threads, int write_percent, bool& consistent) {
+        RwLock rw;
+        SharedRecord record;
+        atomic<bool> stop{false};
+        atomic<long long> total{0};
+        atomic<bool> torn{false};
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                uint32_t rng = 2463534242u + t;   // xorshift: cheaper than the operation
+                long long ops = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    rng ^= rng << 13;
+                    rng ^= rng >> 17;
+                    rng ^= rng << 5;
+                    if ((int)(rng % 100) < write_percent) {
+                        unique_lock<RwLock> lock(rw);
+                        for (long long& f : record.fields) f++;
+                    } else {
+                        shared_lock<RwLock> lock(rw);
+                        for (int f = 1; f < FIELDS; ++f) {
+                            if (record.fields[f] != record.fields[0]) torn = true;
+                        }
+                    }
+                    ops++;
+                }
+                total += ops;
+            });
+        }
+        this_thread::sleep_for(milliseconds(RUN_MS));
+        stop = true;
+        for (auto& w : workers) w.join();
+        consistent = consistent && !torn;
+        return total / (RUN_MS * 1000.0);
+    }
+
+    template<typename RwLock>
+    static void row(const char* name, int threads, bool& consistent) {
+        cout << left << setw(20) << name << right;
+        for (int write_percent : {1, 10, 50}) cout << setw(10) << measure<RwLock>(threads, write_percent, consistent);
+        cout << endl;
+    }
+
+public:
+    static void demonstrate_readers_writers() {
+        cout << "\n=== READERS-WRITERS LOCKS ===" << endl;
+        int threads = max(4, (int)thread::hardware_concurrency());
+        cout << threads << " threads, millions of operations per second at read/write ratios:" << endl;
+        cout << left << setw(20) << "lock" << right << setw(10) << "99/1" << setw(10) << "90/10"
+             << setw(10) << "50/50" << endl;
+
+        bool consistent = true;
+        cout << fixed << setprecision(2);
+        row<ExclusiveOnly>("mutex (exclusive)", threads, consistent);
+        row<shared_mutex>("shared_mutex", threads, consistent);
+        row<WriterPreferringRwLock>("writer-preferring", threads, consistent);
+        row<BigReaderLock>("big reader", threads, consistent);
+        cout << "No reader saw a half-done write: " << (consistent ? "SUCCESS" : "FAILED") << endl;
     }
 };
 
+//=============================================================================
+// 7. MONITOR IMPLEMENTATION (Section 6.7)
+//=============================================================================
+
+// Monitor<T> (monitor.h) owns the allocator's state; the only way in is
+// through execute(), which holds the monitor lock, and waiting happens on
+// a named condition queue with that same lock, never a second one.
+
 class ResourceAllocator {
 private:
-    Monitor monitor;
-    bool busy = false;
-    condition_variable resource_available;
+    struct State {
+        bool busy = false;
+    };
+
+    Monitor<State> monitor;
+    Monitor<State>::Condition& resource_available = monitor.condition("resource available");
     
 public:
     void acquire(int time) {
-        monitor.execute([&]() {
-            while (busy) {
-                monitor.wait_x();
-            }
-            busy = true;
+        monitor.execute([&](Monitor<State>::Access& m) {
+            m.wait(resource_available, [&] { return !m->busy; });
+            m->busy = true;
             cout << "Resource acquired for " << time << " seconds" << endl;
         });
     }
     
     void release() {
-        monitor.execute([&]() {
-            busy = false;
-            monitor.signal_x();
+        monitor.execute([&](Monitor<State>::Access& m) {
+            m->busy = false;
+            m.notify_one(resource_available);
             cout << "Resource released" << endl;
         });
     }
@@ -489,6 +1102,237 @@ public:
     }
 };
 
+//=============================================================================
+// 7b. READING SHARED STATE WITHOUT A LOCK: SEQLOCK AND RCU
+//=============================================================================
+
+class LockFreeReads {
+private:
+    static constexpr int RUN_MS = 200;
+
+    // The kind of status ResourceAllocator keeps. Consistent when
+    // acquisitions - releases == busy and holder is set exactly when busy.
+    struct AllocatorStatus {
+        long long acquisitions = 0;
+        long long releases = 0;
+        int busy = 0;
+        int holder = -1;
+    };
+
+    static bool consistent(const AllocatorStatus& s) {
+        return s.acquisitions - s.releases == s.busy && (s.busy == 1) == (s.holder >= 0);
+    }
+
+    // Alternately acquires and releases on behalf of process `step`.
+    static void nextState(AllocatorStatus& s, long long step) {
+        if (s.busy) {
+            s.releases++;
+            s.busy = 0;
+            s.holder = -1;
+        } else {
+            s.acquisitions++;
+            s.busy = 1;
+            s.holder = (int)(step % 16);
+        }
+    }
+
+    // Reading and writing through one mutex, like Monitor::execute.
+    struct MonitorStatus {
+        mutex mtx;
+        AllocatorStatus status;
+
+        struct Reader {
+            MonitorStatus* m;
+            AllocatorStatus read() {
+                lock_guard<mutex> lock(m->mtx);
+                return m->status;
+            }
+        };
+        Reader reader() { return {this}; }
+        template<typename Fn>
+        void update(Fn fn) {
+            lock_guard<mutex> lock(mtx);
+            fn(status);
+        }
+    };
+
+    struct SeqLockStatus {
+        SeqLock<AllocatorStatus> status;
+
+        struct Reader {
+            SeqLockStatus* s;
+            AllocatorStatus read() { return s->status.load(); }
+        };
+        Reader reader() { return {this}; }
+        template<typename Fn>
+        void update(Fn fn) { status.update(fn); }
+    };
+
+    struct RcuStatus {
+        Rcu<AllocatorStatus> status{AllocatorStatus()};
+
+        struct Reader {
+            Rcu<AllocatorStatus>::Reader r;
+            AllocatorStatus read() { return *r.read(); }
+        };
+        Reader reader() { return {status.reader()}; }
+        template<typename Fn>
+        void update(Fn fn) { status.update(fn); }
+    };
+
+    struct Result {
+        double reads;    // millions per second, all readers together
+        double writes;   // thousands per second
+        bool ok;
+    };
+
+    // `readers` threads read the status as fast as they can while one
+    // writer updates it, flat out or pausing `pause_us` between updates.
+    template<typename Shared>
+    static Result measure(int readers, int pause_us) {
+        Shared shared;
+        atomic<bool> stop{false};
+        atomic<long long> reads{0};
+        atomic<bool> ok{true};
+        long long writes = 0;
+
+        vector<thread> threads;
+        for (int t = 0; t < readers; ++t) {
+            threads.emplace_back([&]() {
+                auto reader = shared.reader();
+                long long mine = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    if (!consistent(reader.read())) ok = false;
+                    mine++;
+                }
+                reads += mine;
+            });
+        }
+        threads.emplace_back([&]() {
+            while (!stop.load(memory_order_relaxed)) {
+                shared.update([&](AllocatorStatus& s) { nextState(s, writes); });
+                writes++;
+                if (pause_us) this_thread::sleep_for(microseconds(pause_us));
+            }
+        });
+        this_thread::sleep_for(milliseconds(RUN_MS));
+        stop = true;
+        for (auto& t : threads) t.join();
+        return {reads / (RUN_MS * 1000.0), writes / (double)RUN_MS, ok};
+    }
+
+    template<typename Shared>
+    static void row(const char* name, int readers, bool& all_ok) {
+        cout << left << setw(16) << name << right;
+        for (int pause_us : {100, 0}) {
+            Result r = measure<Shared>(readers, pause_us);
+            all_ok = all_ok && r.ok;
+            cout << setw(12) << r.reads << setw(12) << r.writes;
+        }
+        cout << endl;
+    }
+
+public:
+    static void demonstrate_lock_free_reads() {
+        cout << "\n=== SEQLOCK AND RCU VS MONITOR MUTEX ===" << endl;
+        int readers = max(3, (int)thread::hardware_concurrency() - 1);
+        cout << readers << " readers and 1 writer; reads in millions/s, writes in thousands/s" << endl;
+        cout << left << setw(16) << "" << right << setw(24) << "writer pauses 100us" << setw(24) << "writer flat out" << endl;
+        cout << left << setw(16) << "method" << right << setw(12) << "reads" << setw(12) << "writes"
+             << setw(12) << "reads" << setw(12) << "writes" << endl;
+
+        bool all_ok = true;
+        cout << fixed << setprecision(2);
+        row<MonitorStatus>("monitor mutex", readers, all_ok);
+        row<SeqLockStatus>("seqlock", readers, all_ok);
+        row<RcuStatus>("RCU", readers, all_ok);
+        cout << "Every read saw a consistent status: " << (all_ok ? "SUCCESS" : "FAILED") << endl;
+    }
+};
+
+//=============================================================================
+// 7c. MONITOR WAKEUP LATENCY UNDER MANY WAITERS
+//=============================================================================
+
+class MonitorWakeups {
+private:
+    static constexpr int ROUNDS = 1000;
+
+    // One permit at a time is handed to a crowd of waiters; each handoff's
+    // latency runs from the release to the moment a waiter holds the permit.
+    struct Exchange {
+        int permits = 0;
+        int rounds_left = ROUNDS;
+        steady_clock::time_point released_at;
+        vector<double> latency_us;
+    };
+
+    static double percentile(vector<double>& v, double p) {
+        sort(v.begin(), v.end());
+        return v[min(v.size() - 1, (size_t)(p / 100.0 * v.size()))];
+    }
+
+    // notify_all: the way a single shared condition is often used, where
+    // every waiter wakes and all but one go back to sleep.
+    static void run(int waiters, bool wake_all) {
+        Monitor<Exchange> monitor;
+        auto& available = monitor.condition("permit available");
+        auto& taken = monitor.condition("permit taken");
+
+        vector<thread> threads;
+        for (int w = 0; w < waiters; ++w) {
+            threads.emplace_back([&]() {
+                while (true) {
+                    bool done = monitor.execute([&](Monitor<Exchange>::Access& m) {
+                        m.wait(available, [&] { return m->permits > 0 || m->rounds_left == 0; });
+                        if (m->permits == 0) return true;
+                        m->permits--;
+                        m->latency_us.push_back(
+                            duration<double, micro>(steady_clock::now() - m->released_at).count());
+                        m.notify_one(taken);
+                        return false;
+                    });
+                    if (done) return;
+                }
+            });
+        }
+
+        auto start = steady_clock::now();
+        for (int r = 0; r < ROUNDS; ++r) {
+            monitor.execute([&](Monitor<Exchange>::Access& m) {
+                m->permits++;
+                m->rounds_left--;
+                m->released_at = steady_clock::now();
+                if (wake_all) m.notify_all(available);
+                else m.notify_one(available);
+                m.wait(taken, [&] { return m->permits == 0; });
+            });
+        }
+        double secs = duration<double>(steady_clock::now() - start).count();
+        monitor.execute([&](Monitor<Exchange>::Access& m) { m.notify_all(available); });
+        for (auto& t : threads) t.join();
+
+        vector<double> latency = monitor.execute([](Monitor<Exchange>::Access& m) { return m->latency_us; });
+        cout << setw(8) << waiters << setw(12) << (wake_all ? "notify_all" : "notify_one")
+             << setw(10) << percentile(latency, 50) << setw(10) << percentile(latency, 99)
+             << setw(10) << latency.back() << setw(12) << ROUNDS / secs / 1000.0
+             << (latency.size() == ROUNDS ? "" : "  (lost a wakeup!)") << endl;
+    }
+
+public:
+    static void demonstrate_monitor_wakeups() {
+        cout << "\n=== MONITOR WAKEUP LATENCY ===" << endl;
+        cout << ROUNDS << " handoffs of one permit; latency in microseconds" << endl;
+        cout << setw(8) << "waiters" << setw(12) << "notify" << setw(10) << "p50" << setw(10) << "p99"
+             << setw(10) << "max" << setw(12) << "k handoff/s" << endl;
+        cout << fixed << setprecision(1);
+        for (int waiters : {10, 100, 500}) {
+            run(waiters, false);
+            run(waiters, true);
+        }
+    }
+};
+
 //=============================================================================
 // 8. DINING PHILOSOPHERS PROBLEM (Classic Synchronization Problem)
 //=============================================================================
@@ -563,22 +1407,31 @@ int main() {
         
         // 2. Peterson's Solution
         PetersonSolution::demonstrate_peterson();
+        SoftwareLockCost::demonstrate_software_lock_cost();
         
         // 3. Hardware Instructions
         HardwareInstructions::demonstrate_test_and_set();
         HardwareInstructions::demonstrate_compare_and_swap();
+        SpinlockComparison::demonstrate_spinlocks();
         
         // 4. Mutex Locks
         MutexDemo::demonstrate_mutex();
+        CounterScaling::demonstrate_counter_scaling();
         
         // 5. Semaphores
         SemaphoreDemo::demonstrate_semaphore();
+        SemaphoreComparison::demonstrate_semaphore_comparison();
         
         // 6. Producer-Consumer Problem
         ProducerConsumer::demonstrate_producer_consumer();
+        QueueThroughput::demonstrate_queue_throughput();
+        SpscThroughput::demonstrate_spsc_throughput();
+        ReadersWriters::demonstrate_readers_writers();
         
         // 7. Monitor
         ResourceAllocator::demonstrate_monitor();
+        LockFreeReads::demonstrate_lock_free_reads();
+        MonitorWakeups::demonstrate_monitor_wakeups();
         
         // 8. Dining Philosophers
         DiningPhilosophers::demonstrate_dining_philosophers();
@@ -605,10 +1458,16 @@ int main() {
  * LEARNING OBJECTIVES:
  * After studying this code, students should understand:
  * 1. How race conditions occur and their consequences
- * 2. Peterson's algorithm for mutual exclusion
- * 3. Hardware-based synchronization primitives
- * 4. Mutex locks and their proper usage
- * 5. Semaphore operations and resource management (with custom implementation)
- * 6. Monitor concept and implementation
- * 7. Classic synchronization problems and solutions
+ * 2. Peterson's algorithm for mutual exclusion, why it needs ordered
+ *    atomics, and what the N-thread filter and bakery locks cost
+ * 3. Hardware-based synchronization primitives, and the spinlocks built on
+ *    them (backoff, tickets, queue locks) and where spinning stops paying
+ * 4. Mutex locks and their proper usage, and why sharding beats any
+ *    single shared counter once many threads increment it
+ * 5. Semaphore operations and resource management (with custom implementation),
+ *    and how a futex keeps the uncontended case out of the kernel
+ * 6. Monitor concept and implementation, and reader-writer locks,
+ *    seqlocks and RCU for read-mostly data
+ * 7. Classic synchronization problems and solutions, and how a lock-free
+ *    ring lets producers and consumers stop waiting on one another's lock
  */
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * Read-copy-update style publication of immutable snapshots, with
+ * epoch-based reclamation: readers are wait-free, writers copy, publish
+ * and free old versions once no reader can still be looking at them.
+ */
+
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//=============================================================================
+// RCU SNAPSHOTS WITH EPOCH-BASED RECLAMATION
+//=============================================================================
+//
+// The current value lives behind one atomic pointer. A writer copies it,
+// changes the copy and swaps the pointer; readers that already hold the old
+// snapshot keep reading it undisturbed. The question is when the old one
+// may be freed.
+//
+// Each reader owns a padded slot. Entering a read section it copies the
+// global epoch into its slot; leaving, it writes 0 (quiescent). A writer
+// swaps the pointer, then advances the epoch and tags the old snapshot with
+// the new epoch number. A reader whose slot holds that number or more
+// entered after the swap and so can only see the new snapshot; once every
+// slot is either quiescent or at least the tag, nobody can hold the old
+// one, and it is freed.
+//
+// Readers do a load and two stores, never wait and never retry. Writers
+// are serialised by a mutex and free what they can after each update;
+// synchronize() waits until everything retired so far is gone.
+//
+// Every reading thread registers once with reader() and keeps the Reader
+// while it reads; the slot is handed back when the Reader is destroyed.
+
+template<typename T>
+class Rcu {
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};   // 0: not reading
+        std::atomic<bool> in_use{false};
+    };
+
+    struct Retired {
+        const T* snapshot;
+        uint64_t epoch;
+    };
+
+    std::atomic<const T*> current;
+    alignas(64) std::atomic<uint64_t> global_epoch{1};
+    std::unique_ptr<ReaderSlot[]> slots;
+    size_t slot_count;
+
+    std::mutex writer_mtx;
+    std::vector<Retired> retired;   // guarded by writer_mtx
+
+    // Lowest epoch any reader is in, or UINT64_MAX if none is reading.
+    uint64_t oldestActiveEpoch() const {
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < slot_count; ++i) {
+            uint64_t e = slots[i].epoch.load();
+            if (e != 0 && e < oldest) oldest = e;
+        }
+        return oldest;
+    }
+
+    // Caller holds writer_mtx.
+    void reclaim() {
+        uint64_t oldest = oldestActiveEpoch();
+        size_t kept = 0;
+        for (const Retired& r : retired) {
+            if (r.epoch <= oldest) delete r.snapshot;
+            else retired[kept++] = r;
+        }
+        retired.resize(kept);
+    }
+
+public:
+    // A registered reader. read() returns a Snapshot that keeps the value it
+    // points at alive until the Snapshot goes out of scope.
+    class Reader {
+    private:
+        Rcu* rcu;
+        ReaderSlot* slot;
+
+    public:
+        class Snapshot {
+        private:
+            ReaderSlot* slot;
+            const T* value;
+
+        public:
+            Snapshot(ReaderSlot* s, const T* v) : slot(s), value(v) {}
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+            ~Snapshot() { slot->epoch.store(0, std::memory_order_release); }
+
+            const T& operator*() const { return *value; }
+            const T* operator->() const { return value; }
+        };
+
+        Reader(Rcu* r, ReaderSlot* s) : rcu(r), slot(s) {}
+        Reader(Reader&& other) noexcept : rcu(other.rcu), slot(other.slot) { other.slot = nullptr; }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader() {
+            if (slot) slot->in_use.store(false, std::memory_order_release);
+        }
+
+        // One read section at a time per Reader.
+        Snapshot read() {
+            // Announce the epoch before loading the pointer, both seq_cst,
+            // so a writer that does not see the announcement swapped before
+            // our load and we get the new snapshot.
+            slot->epoch.store(rcu->global_epoch.load());
+            return Snapshot(slot, rcu->current.load());
+        }
+    };
+
+    explicit Rcu(const T& initial, size_t max_readers = 64)
+        : current(new T(initial)), slots(new ReaderSlot[max_readers ? max_readers : 1]),
+          slot_count(max_readers ? max_readers : 1) {}
+
+    Rcu(const Rcu&) = delete;
+    Rcu& operator=(const Rcu&) = delete;
+
+    // No reader may be left when the Rcu goes.
+    ~Rcu() {
+        for (const Retired& r : retired) delete r.snapshot;
+        delete current.load();
+    }
+
+    Reader reader() {
+        for (size_t i = 0; i < slot_count; ++i) {
+            bool expected = false;
+            if (slots[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return Reader(this, &slots[i]);
+            }
+        }
+        throw std::runtime_error("Rcu: no free reader slot");
+    }
+
+    // Copies the current value, lets fn change the copy, and publishes it.
+    template<typename Fn>
+    void update(Fn fn) {
+        std::lock_guard<std::mutex> lock(writer_mtx);
+        std::unique_ptr<T> next(new T(*current.load()));
+        fn(*next);
+        const T* old = current.exchange(next.release());
+        retired.push_back({old, global_epoch.fetch_add(1) + 1});
+        reclaim();
+    }
+
+    // Waits until every snapshot retired so far has been freed.
+    void synchronize() {
+        std::unique_lock<std::mutex> lock(writer_mtx);
+        while (true) {
+            reclaim();
+            if (retired.empty()) return;
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    // Snapshots retired but not yet freed.
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(writer_mtx);
+        return retired.size();
+    }
+};
+
+#endif // RCU_H
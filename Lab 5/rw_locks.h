@@ -0,0 +1,135 @@
+/*
+ * Reader-writer locks for read-mostly data (the readers-writers problem):
+ * a writer-preferring lock and a "big reader" lock whose readers only
+ * touch their own cache line. Both provide lock/unlock for writers and
+ * lock_shared/unlock_shared for readers, the same interface as
+ * std::shared_mutex, so they work with unique_lock and shared_lock.
+ */
+
+#ifndef RW_LOCKS_H
+#define RW_LOCKS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//=============================================================================
+// WRITER-PREFERRING READERS-WRITER LOCK
+//=============================================================================
+//
+// The textbook monitor solution with the priority turned around: as soon
+// as a writer is waiting, new readers queue behind it, so a steady stream
+// of readers cannot starve writers (glibc's shared_mutex lets readers in
+// whenever other readers hold the lock). Readers still all go through one
+// mutex, so this is about policy, not about read scalability.
+
+class WriterPreferringRwLock {
+private:
+    std::mutex mtx;
+    std::condition_variable readers_cv, writers_cv;
+    int active_readers = 0;
+    int waiting_writers = 0;
+    bool writer_active = false;
+
+public:
+    void lock_shared() {
+        std::unique_lock<std::mutex> lock(mtx);
+        readers_cv.wait(lock, [this] { return !writer_active && waiting_writers == 0; });
+        active_readers++;
+    }
+
+    void unlock_shared() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--active_readers == 0 && waiting_writers > 0) writers_cv.notify_one();
+    }
+
+    void lock() {
+        std::unique_lock<std::mutex> lock(mtx);
+        waiting_writers++;
+        writers_cv.wait(lock, [this] { return !writer_active && active_readers == 0; });
+        waiting_writers--;
+        writer_active = true;
+    }
+
+    void unlock() {
+        std::lock_guard<std::mutex> lock(mtx);
+        writer_active = false;
+        // Writers first; readers only once no writer is left waiting.
+        if (waiting_writers > 0) writers_cv.notify_one();
+        else readers_cv.notify_all();
+    }
+};
+
+//=============================================================================
+// BIG READER LOCK
+//=============================================================================
+//
+// Each reader announces itself in its own padded slot and then checks a
+// single writer flag that, while no writer comes along, every core keeps
+// in its cache read-only. A read lock/unlock therefore writes only to a
+// line nobody else uses. A writer pays for it: it raises the flag and then
+// has to visit every slot until all readers have left.
+//
+// Slots are per thread, not per CPU: a thread can migrate between
+// lock_shared and unlock_shared, and must decrement the slot it
+// incremented. With more threads than slots, threads share a slot, which
+// stays correct and only costs some of the scalability.
+
+class BigReaderLock {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<int> readers{0};
+    };
+
+    size_t slot_count;
+    std::unique_ptr<Slot[]> slots;
+    alignas(CACHE_LINE) std::atomic<bool> writer{false};
+    std::mutex writer_mtx;   // one writer at a time
+
+    static size_t threadSlot() {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    Slot& mySlot() { return slots[threadSlot() % slot_count]; }
+
+public:
+    explicit BigReaderLock(size_t count = 2 * std::thread::hardware_concurrency())
+        : slot_count(count ? count : 1), slots(new Slot[slot_count]) {}
+
+    // Announce, then check for a writer; the writer raises its flag, then
+    // checks for readers. With both sequentially consistent, at least one
+    // of them sees the other.
+    void lock_shared() {
+        Slot& slot = mySlot();
+        while (true) {
+            slot.readers.fetch_add(1);
+            if (!writer.load()) return;
+            slot.readers.fetch_sub(1, std::memory_order_relaxed);
+            while (writer.load(std::memory_order_relaxed)) std::this_thread::yield();
+        }
+    }
+
+    void unlock_shared() { mySlot().readers.fetch_sub(1, std::memory_order_release); }
+
+    void lock() {
+        writer_mtx.lock();
+        writer.store(true);
+        for (size_t i = 0; i < slot_count; ++i) {
+            while (slots[i].readers.load() != 0) std::this_thread::yield();
+        }
+    }
+
+    void unlock() {
+        writer.store(false, std::memory_order_release);
+        writer_mtx.unlock();
+    }
+};
+
+#endif // RW_LOCKS_H
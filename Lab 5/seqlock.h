@@ -0,0 +1,97 @@
+/*
+ * Sequence lock for small, trivially copyable state that is read far more
+ * often than it is written: readers take no lock and never make a writer
+ * wait; they just retry if a write overlapped their copy.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+#include "spinlocks.h"   // cpuRelax()
+
+//=============================================================================
+// SEQLOCK
+//=============================================================================
+//
+// The sequence number is odd while a write is in progress. A reader notes
+// it, copies the data, and checks it again: if it was even and has not
+// changed, nobody wrote in between and the copy is consistent. Writers are
+// serialised by a mutex and never wait for readers.
+//
+// A reader can be copying while the writer is storing, so the data is kept
+// as relaxed atomic words rather than a plain T: that makes the overlap a
+// well-defined (if useless) read instead of a data race, and the fences
+// order the words against the sequence number (Boehm, "Can Seqlocks Get
+// Along with Programming Language Memory Models?").
+
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies T word by word");
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> words[WORDS];
+    std::mutex writer_mtx;
+
+    void storeWords(const T& value) {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    // Caller holds writer_mtx.
+    void publish(const T& value) {
+        uint32_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        storeWords(value);
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+public:
+    explicit SeqLock(const T& initial = T()) { storeWords(initial); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const {
+        uint64_t buffer[WORDS];
+        while (true) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {           // a write is in progress
+                cpuRelax();
+                continue;
+            }
+            for (size_t i = 0; i < WORDS; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    void store(const T& value) {
+        std::lock_guard<std::mutex> lock(writer_mtx);
+        publish(value);
+    }
+
+    // Read-modify-write under the writer mutex.
+    template<typename Fn>
+    void update(Fn fn) {
+        std::lock_guard<std::mutex> lock(writer_mtx);
+        T value = load();
+        fn(value);
+        publish(value);
+    }
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,69 @@
+/*
+ * Sharded counter: a contention-free replacement for a mutex-protected
+ * (or single atomic) counter that many threads increment and few read.
+ */
+
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+//=============================================================================
+// SHARDED COUNTER
+//=============================================================================
+//
+// Every thread adds to its own shard, each on its own cache line, with a
+// relaxed fetch_add: no lock, and no cache line bouncing between cores as
+// long as there are at least as many shards as incrementing threads.
+// read() sums the shards on demand. It is exact once the writers have
+// stopped (e.g. after join); while they run it returns some value between
+// the counts before and after the read, which is all a statistic needs.
+
+class ShardedCounter {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Shard {
+        std::atomic<long long> value{0};
+    };
+
+    size_t shard_count;
+    std::unique_ptr<Shard[]> shards;
+
+    // Threads get consecutive slots the first time they touch any counter,
+    // so up to shard_count threads never share a shard.
+    static size_t threadSlot() {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+public:
+    explicit ShardedCounter(size_t count = 2 * std::thread::hardware_concurrency())
+        : shard_count(count ? count : 1), shards(new Shard[shard_count]) {}
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(long long n = 1) {
+        shards[threadSlot() % shard_count].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    long long read() const {
+        long long total = 0;
+        for (size_t i = 0; i < shard_count; ++i) total += shards[i].value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Only meaningful while no thread is adding.
+    void reset() {
+        for (size_t i = 0; i < shard_count; ++i) shards[i].value.store(0, std::memory_order_relaxed);
+    }
+
+    size_t shardCount() const { return shard_count; }
+};
+
+#endif // SHARDED_COUNTER_H
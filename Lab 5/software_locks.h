@@ -0,0 +1,138 @@
+/*
+ * Mutual exclusion from loads and stores alone, generalised from Peterson's
+ * two-thread solution (Section 6.3) to N threads: the filter lock and
+ * Lamport's bakery lock.
+ *
+ * Peterson's argument assumes every store is seen by the other threads
+ * before the thread's own next load. Real CPUs buffer stores (x86 lets a
+ * later load pass an earlier store), and the compiler may reorder or cache
+ * plain variables, so all shared state here is std::atomic with the
+ * default sequentially consistent ordering, which restores that assumption
+ * at the price of a full fence per store.
+ *
+ * Threads identify themselves with an id in [0, n), so these locks take
+ * the id in lock(id)/unlock(id) rather than being Lockable.
+ */
+
+#ifndef SOFTWARE_LOCKS_H
+#define SOFTWARE_LOCKS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "spinlocks.h"   // cpuRelax()
+
+//=============================================================================
+// PETERSON'S LOCK (2 threads)
+//=============================================================================
+
+class PetersonLock {
+private:
+    std::atomic<bool> flag[2] = {{false}, {false}};
+    std::atomic<int> turn{0};
+
+public:
+    explicit PetersonLock(int = 2) {}
+
+    void lock(int me) {
+        int other = 1 - me;
+        flag[me].store(true);
+        turn.store(other);
+        while (flag[other].load() && turn.load() == other) cpuRelax();
+    }
+
+    void unlock(int me) { flag[me].store(false); }
+};
+
+//=============================================================================
+// FILTER LOCK (N threads)
+//=============================================================================
+//
+// n - 1 waiting rooms, each a Peterson-style gate: at level L a thread
+// announces itself and volunteers as the victim, and waits while it is the
+// victim and any other thread is at level L or above. At most n - L threads
+// get past level L, so one reaches the critical section. Each acquisition
+// costs O(n^2) loads even without contention, and it is not FIFO.
+
+class FilterLock {
+private:
+    struct alignas(64) Slot {
+        std::atomic<int> value{0};
+    };
+
+    int n;
+    std::unique_ptr<Slot[]> level;    // level[i]: the room thread i is in
+    std::unique_ptr<Slot[]> victim;   // victim[L]: last thread to enter room L
+
+    bool othersAtOrAbove(int me, int L) const {
+        for (int k = 0; k < n; ++k) {
+            if (k != me && level[k].value.load() >= L) return true;
+        }
+        return false;
+    }
+
+public:
+    explicit FilterLock(int threads) : n(threads), level(new Slot[threads]), victim(new Slot[threads]) {}
+
+    void lock(int me) {
+        for (int L = 1; L < n; ++L) {
+            level[me].value.store(L);
+            victim[L].value.store(me);
+            while (victim[L].value.load() == me && othersAtOrAbove(me, L)) cpuRelax();
+        }
+    }
+
+    void unlock(int me) { level[me].value.store(0); }
+};
+
+//=============================================================================
+// BAKERY LOCK (N threads, Lamport)
+//=============================================================================
+//
+// Take a number one higher than any you can see, then wait for everyone
+// holding a smaller (number, id) pair. Threads choosing at the same moment
+// may draw equal numbers; the id breaks the tie, and the choosing flag
+// stops anyone comparing against a number that is still being drawn.
+// First-come first-served, O(n) loads per acquisition. The numbers only
+// grow while the lock is never idle, which 64 bits make a non-issue.
+
+class BakeryLock {
+private:
+    struct alignas(64) Entry {
+        std::atomic<bool> choosing{false};
+        std::atomic<uint64_t> number{0};
+    };
+
+    int n;
+    std::unique_ptr<Entry[]> entries;
+
+public:
+    explicit BakeryLock(int threads) : n(threads), entries(new Entry[threads]) {}
+
+    void lock(int me) {
+        entries[me].choosing.store(true);
+        uint64_t highest = 0;
+        for (int k = 0; k < n; ++k) {
+            uint64_t ticket = entries[k].number.load();
+            if (ticket > highest) highest = ticket;
+        }
+        uint64_t mine = highest + 1;
+        entries[me].number.store(mine);
+        entries[me].choosing.store(false);
+
+        for (int k = 0; k < n; ++k) {
+            if (k == me) continue;
+            while (entries[k].choosing.load()) cpuRelax();
+            while (true) {
+                uint64_t theirs = entries[k].number.load();
+                if (theirs == 0 || theirs > mine || (theirs == mine && k > me)) break;
+                cpuRelax();
+            }
+        }
+    }
+
+    void unlock(int me) { entries[me].number.store(0); }
+};
+
+#endif // SOFTWARE_LOCKS_H
@@ -0,0 +1,209 @@
+/*
+ * Spinlocks built up from the test-and-set loop of Section 6.4: plain
+ * test-and-set, test-and-test-and-set with exponential backoff, a ticket
+ * lock and an MCS queue lock. Each has lock(), unlock() and try_lock(), so
+ * it meets the standard Lockable requirements and works with lock_guard,
+ * unique_lock and scoped_lock.
+ */
+
+#ifndef SPINLOCKS_H
+#define SPINLOCKS_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Tells the CPU we are in a spin-wait loop: on x86 `pause` stops the loop
+// from flooding the memory pipeline and yields to a hyperthread sibling.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+//=============================================================================
+// TEST-AND-SET
+//=============================================================================
+//
+// What HardwareInstructions::safe_increment_tas does: every spin is an
+// exchange, i.e. a write, so each waiter keeps pulling the lock's cache
+// line away from everyone else, the holder included.
+
+class TasLock {
+private:
+    std::atomic<bool> locked{false};
+
+public:
+    void lock() {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+        }
+    }
+    bool try_lock() { return !locked.exchange(true, std::memory_order_acquire); }
+    void unlock() { locked.store(false, std::memory_order_release); }
+};
+
+//=============================================================================
+// TEST-AND-TEST-AND-SET WITH EXPONENTIAL BACKOFF
+//=============================================================================
+//
+// Waiters spin on a plain load, which is served from their own cached copy
+// of the line, and only try the exchange once the lock looks free. After
+// losing that race a waiter pauses for a doubling number of cpuRelax()
+// rounds, so a crowd of waiters does not stampede the line every time it
+// is released.
+
+class TtasLock {
+private:
+    static constexpr int MIN_BACKOFF = 4;
+    static constexpr int MAX_BACKOFF = 1024;
+
+    std::atomic<bool> locked{false};
+
+public:
+    void lock() {
+        int backoff = MIN_BACKOFF;
+        while (true) {
+            while (locked.load(std::memory_order_relaxed)) cpuRelax();
+            if (!locked.exchange(true, std::memory_order_acquire)) return;
+            for (int i = 0; i < backoff; ++i) cpuRelax();
+            if (backoff < MAX_BACKOFF) backoff *= 2;
+        }
+    }
+
+    bool try_lock() {
+        return !locked.load(std::memory_order_relaxed) && !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() { locked.store(false, std::memory_order_release); }
+};
+
+//=============================================================================
+// TICKET LOCK
+//=============================================================================
+//
+// Like a bakery counter: take the next ticket, wait until it is served.
+// Waiters are served strictly in arrival order, so nobody starves, and each
+// backs off in proportion to how many are ahead of it. All waiters still
+// spin on the one now_serving line.
+
+class TicketLock {
+private:
+    alignas(64) std::atomic<uint32_t> next_ticket{0};
+    alignas(64) std::atomic<uint32_t> now_serving{0};
+
+public:
+    void lock() {
+        uint32_t ticket = next_ticket.fetch_add(1, std::memory_order_relaxed);
+        while (true) {
+            uint32_t serving = now_serving.load(std::memory_order_acquire);
+            if (serving == ticket) return;
+            for (uint32_t i = 0; i < 32 * (ticket - serving); ++i) cpuRelax();
+        }
+    }
+
+    bool try_lock() {
+        uint32_t serving = now_serving.load(std::memory_order_acquire);
+        uint32_t expected = serving;
+        return next_ticket.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire,
+                                                   std::memory_order_relaxed);
+    }
+
+    // Only the holder writes now_serving, so a plain load + store will do.
+    void unlock() {
+        now_serving.store(now_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+//=============================================================================
+// MCS QUEUE LOCK (Mellor-Crummey & Scott)
+//=============================================================================
+//
+// Waiters form a linked queue, and each spins on a flag in its own node, on
+// its own cache line: the holder hands the lock over by writing only its
+// successor's flag. FIFO like the ticket lock, but a release touches one
+// waiter instead of all of them.
+//
+// Lockable's unlock() takes no arguments, so the holder's node is kept in
+// the lock itself, and nodes come from a small per-thread free list (a
+// thread may hold several MCS locks at once).
+
+class McsLock {
+private:
+    struct alignas(64) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> waiting{false};
+    };
+
+    std::atomic<Node*> tail{nullptr};
+    Node* holder = nullptr;   // written by each new holder, read at unlock
+
+    struct NodePool {
+        std::vector<Node*> free_nodes;
+        ~NodePool() {
+            for (Node* n : free_nodes) delete n;
+        }
+    };
+
+    static Node* takeNode() {
+        NodePool& pool = threadPool();
+        if (pool.free_nodes.empty()) return new Node;
+        Node* n = pool.free_nodes.back();
+        pool.free_nodes.pop_back();
+        return n;
+    }
+
+    // Once unlock has handed over, nobody refers to our node any more.
+    static void giveNode(Node* n) { threadPool().free_nodes.push_back(n); }
+
+    static NodePool& threadPool() {
+        thread_local NodePool pool;
+        return pool;
+    }
+
+public:
+    void lock() {
+        Node* me = takeNode();
+        me->next.store(nullptr, std::memory_order_relaxed);
+        me->waiting.store(true, std::memory_order_relaxed);
+        Node* prev = tail.exchange(me, std::memory_order_acq_rel);
+        if (prev) {
+            prev->next.store(me, std::memory_order_release);
+            while (me->waiting.load(std::memory_order_acquire)) cpuRelax();
+        }
+        holder = me;
+    }
+
+    bool try_lock() {
+        Node* me = takeNode();
+        me->next.store(nullptr, std::memory_order_relaxed);
+        Node* expected = nullptr;
+        if (!tail.compare_exchange_strong(expected, me, std::memory_order_acquire, std::memory_order_relaxed)) {
+            giveNode(me);
+            return false;
+        }
+        holder = me;
+        return true;
+    }
+
+    void unlock() {
+        Node* me = holder;
+        Node* successor = me->next.load(std::memory_order_acquire);
+        if (!successor) {
+            // Nobody queued behind us: try to empty the queue.
+            Node* expected = me;
+            if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+                giveNode(me);
+                return;
+            }
+            // Someone swapped in after us but has not linked up yet.
+            while (!(successor = me->next.load(std::memory_order_acquire))) cpuRelax();
+        }
+        successor->waiting.store(false, std::memory_order_release);
+        giveNode(me);
+    }
+};
+
+#endif // SPINLOCKS_H
@@ -0,0 +1,122 @@
+/*
+ * Bounded single-producer/single-consumer ring buffer: the one-producer,
+ * one-consumer special case of the bounded buffer, with no locks and no
+ * read-modify-write atomics at all.
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+//=============================================================================
+// SPSC RING BUFFER
+//=============================================================================
+//
+// tail is written only by the producer and head only by the consumer, so a
+// plain release store publishes each one and an acquire load reads the
+// other's. Each side also keeps a private copy of the other's index and
+// reloads it only when the copy says the ring is full (producer) or empty
+// (consumer), so in steady state the two threads rarely touch each other's
+// cache line. The batch calls move up to n items for one pair of index
+// updates, which spreads that remaining cost over the whole batch.
+//
+// Exactly one thread may push and exactly one thread may pop. T must be
+// default-constructible and move-assignable.
+
+template<typename T>
+class SpscRing {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    size_t mask;
+    std::unique_ptr<T[]> buffer;
+
+    // Consumer's line: its index and its copy of the producer's.
+    alignas(CACHE_LINE) std::atomic<size_t> head{0};
+    size_t cached_tail = 0;
+
+    // Producer's line.
+    alignas(CACHE_LINE) std::atomic<size_t> tail{0};
+    size_t cached_head = 0;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Free slots as the producer sees them, refreshing head only if needed.
+    size_t freeSlots(size_t t, size_t wanted) {
+        size_t space = capacity() - (t - cached_head);
+        if (space < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            space = capacity() - (t - cached_head);
+        }
+        return space;
+    }
+
+    // Filled slots as the consumer sees them, refreshing tail only if needed.
+    size_t filledSlots(size_t h, size_t wanted) {
+        size_t filled = cached_tail - h;
+        if (filled < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            filled = cached_tail - h;
+        }
+        return filled;
+    }
+
+public:
+    // The capacity is rounded up to a power of two (at least 2).
+    explicit SpscRing(size_t capacity)
+        : mask(roundUpPowerOfTwo(capacity) - 1), buffer(new T[mask + 1]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. Returns false if the ring is full.
+    template<typename U>
+    bool try_push(U&& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (freeSlots(t, 1) == 0) return false;
+        buffer[t & mask] = std::forward<U>(item);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false if the ring is empty.
+    bool try_pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (filledSlots(h, 1) == 0) return false;
+        item = std::move(buffer[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer only. Copies as many of items[0..n) as fit and returns how
+    // many that was.
+    size_t push_batch(const T* items, size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        n = std::min(n, freeSlots(t, n));
+        for (size_t i = 0; i < n; ++i) buffer[(t + i) & mask] = items[i];
+        if (n) tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer only. Moves up to n items into out and returns how many.
+    size_t pop_batch(T* out, size_t n) {
+        size_t h = head.load(std::memory_order_relaxed);
+        n = std::min(n, filledSlots(h, n));
+        for (size_t i = 0; i < n; ++i) out[i] = std::move(buffer[(h + i) & mask]);
+        if (n) head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,27 @@
+/*
+ * Minimal wrappers around the Linux futex system call, shared by the
+ * primitives in this directory that park threads on an atomic int.
+ */
+
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include <atomic>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex needs a plain 32-bit word");
+
+// Sleeps while *word still holds expected. Returns at once if it does not,
+// and may return spuriously, so callers always re-check in a loop.
+inline void futexWait(std::atomic<int>* word, int expected) {
+    syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+// Wakes up to n threads sleeping on word.
+inline void futexWake(std::atomic<int>* word, int n) {
+    syscall(SYS_futex, reinterpret_cast<int*>(word), FUTEX_WAKE_PRIVATE, n, nullptr, nullptr, 0);
+}
+
+#endif // FUTEX_H
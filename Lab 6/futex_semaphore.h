@@ -0,0 +1,73 @@
+/*
+ * Counting semaphore on a Linux futex: the count lives in an atomic, an
+ * uncontended acquire or release is one atomic instruction, and only a
+ * thread that actually has to wait makes a system call.
+ */
+
+#ifndef FUTEX_SEMAPHORE_H
+#define FUTEX_SEMAPHORE_H
+
+#include <atomic>
+
+#include "futex.h"
+
+//=============================================================================
+// FUTEX SEMAPHORE
+//=============================================================================
+//
+// Same interface as the mutex + condition_variable Semaphore. A futex
+// ("fast userspace mutex") is just an int the kernel can sleep on:
+// FUTEX_WAIT sleeps only if the int still holds the value the caller saw,
+// which closes the gap between "count is 0" and "go to sleep", and
+// FUTEX_WAKE wakes sleepers on it.
+//
+// release() increments the count and then looks at waiters; a blocking
+// acquire() increments waiters and then looks at the count. Both pairs are
+// sequentially consistent, so at least one side sees the other: either the
+// waiter finds the permit, or the releaser finds the waiter and wakes it.
+
+class FutexSemaphore {
+private:
+    std::atomic<int> count;
+    std::atomic<int> waiters{0};
+
+public:
+    explicit FutexSemaphore(int initial_count) : count(initial_count) {}
+
+    FutexSemaphore(const FutexSemaphore&) = delete;
+    FutexSemaphore& operator=(const FutexSemaphore&) = delete;
+
+    bool try_acquire() {
+        int c = count.load(std::memory_order_relaxed);
+        while (c > 0) {
+            if (count.compare_exchange_weak(c, c - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void acquire() {
+        if (try_acquire()) return;   // fast path: one CAS
+
+        waiters.fetch_add(1);
+        while (true) {
+            int c = count.load();
+            if (c > 0) {
+                if (count.compare_exchange_weak(c, c - 1, std::memory_order_acquire)) break;
+                continue;
+            }
+            // Returns at once (EAGAIN) if a release got in first; spurious
+            // wakeups just go round the loop again.
+            futexWait(&count, 0);
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void release(int n = 1) {
+        count.fetch_add(n);   // fast path: one atomic add
+        if (waiters.load() > 0) futexWake(&count, n);
+    }
+};
+
+#endif // FUTEX_SEMAPHORE_H
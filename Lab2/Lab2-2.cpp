@@ -0,0 +1,148 @@
+// File: Lab2-2.cpp
+// Compile: g++ -O2 -o Lab2-2 Lab2-2.cpp -std=c++17
+// Usage:   ./Lab2-2 [children] [parent size in MB]...
+//          (default: 1000 children at 0, 64, 256 and 1024 MB)
+//
+// Spawns batches of short-lived children (/bin/true) with fork, vfork,
+// posix_spawn and clone(CLONE_VM) while the parent's resident memory grows,
+// and reports how long each spawn call took and how many children per
+// second were started and reaped.
+//
+// The spawn latency means different things: fork returns as soon as the
+// page tables are copied and leaves the exec to the child, while the other
+// three return only once the child has exec'd. fork's cost grows with the
+// parent's RSS; the others stay flat.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>      // /proc/self/statm
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>     // sysconf(), access()
+#include <sys/mman.h>   // mmap() for the ballast
+
+#include "spawner.h"
+
+using namespace std;
+
+const SpawnMethod ALL_METHODS[] = {
+    SpawnMethod::FORK, SpawnMethod::VFORK, SpawnMethod::POSIX_SPAWN, SpawnMethod::CLONE
+};
+
+long residentMB() {
+    ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+// Grows the parent to about mb of touched, private memory. Every page is
+// written, so fork has a page table entry to copy for each.
+void* growParent(size_t mb) {
+    if (mb == 0) return nullptr;
+    size_t bytes = mb * 1024 * 1024;
+    void* ballast = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ballast == MAP_FAILED) return nullptr;
+    memset(ballast, 1, bytes);
+    return ballast;
+}
+
+struct BatchResult {
+    double seconds;
+    double p50_us;
+    double p99_us;
+    double max_us;
+    long long failed;
+};
+
+BatchResult runBatch(SpawnMethod spawn, ReapMethod reap, int children, const char* path) {
+    char* argv[] = {const_cast<char*>(path), nullptr};
+    vector<double> latency;
+    latency.reserve(children);
+
+    Launcher launcher(spawn, reap);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < children; ++i) {
+        launcher.makeRoom();
+        auto before = chrono::steady_clock::now();
+        launcher.launch(path, argv);
+        latency.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - before).count());
+    }
+    launcher.reapAll();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    sort(latency.begin(), latency.end());
+    return {seconds, latency[latency.size() / 2], latency[latency.size() * 99 / 100], latency.back(),
+            launcher.failed()};
+}
+
+void printRow(const char* name, const BatchResult& r, int children) {
+    cout << fixed << setprecision(1) << left << setw(26) << name << right
+         << setw(12) << children / r.seconds
+         << setw(11) << r.p50_us << setw(11) << r.p99_us << setw(11) << r.max_us;
+    if (r.failed) cout << "  (" << r.failed << " failed)";
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int children = argc > 1 ? atoi(argv[1]) : 1000;
+    vector<size_t> sizes;
+    for (int i = 2; i < argc; ++i) sizes.push_back(strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {0, 64, 256, 1024};
+    if (children <= 0) {
+        cerr << "Error: need a positive number of children" << endl;
+        return 1;
+    }
+
+    const char* path = "/bin/true";
+    if (access(path, X_OK) != 0) {
+        cerr << "Error: " << path << " is not executable" << endl;
+        return 1;
+    }
+    bool pidfd = pidfdSupported();
+
+    cout << "==================================================" << endl;
+    cout << "  PROCESS SPAWN COST VS PARENT SIZE" << endl;
+    cout << "==================================================" << endl;
+    cout << children << " children of " << path << " per batch, at most 64 alive at once" << endl;
+
+    // Sizes are cumulative: each step adds ballast on top of the last.
+    vector<pair<void*, size_t>> ballast;
+    size_t grown = 0;
+    for (size_t mb : sizes) {
+        if (mb > grown) {
+            void* block = growParent(mb - grown);
+            if (!block) {
+                cerr << "Error: cannot grow the parent to " << mb << " MB" << endl;
+                break;
+            }
+            ballast.push_back({block, (mb - grown) * 1024 * 1024});
+            grown = mb;
+        }
+
+        cout << "\n--- Parent RSS " << residentMB() << " MB ---" << endl;
+        cout << left << setw(26) << "Method" << right << setw(12) << "spawns/s"
+             << setw(11) << "p50 us" << setw(11) << "p99 us" << setw(11) << "max us" << endl;
+        try {
+            for (SpawnMethod method : ALL_METHODS) {
+                string name = string(spawnMethodName(method)) + " + " + reapMethodName(ReapMethod::WAITID);
+                printRow(name.c_str(), runBatch(method, ReapMethod::WAITID, children, path), children);
+            }
+            if (pidfd) {
+                string name = string(spawnMethodName(SpawnMethod::POSIX_SPAWN)) + " + " + reapMethodName(ReapMethod::PIDFD);
+                printRow(name.c_str(), runBatch(SpawnMethod::POSIX_SPAWN, ReapMethod::PIDFD, children, path),
+                         children);
+            }
+        } catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+    }
+
+    for (auto& block : ballast) munmap(block.first, block.second);
+    if (!pidfd) cout << "\n(pidfd_open is not available on this kernel)" << endl;
+    return 0;
+}
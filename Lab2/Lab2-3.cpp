@@ -0,0 +1,218 @@
+// File: Lab2-3.cpp
+// Compile: g++ -O2 -o Lab2-3 Lab2-3.cpp -std=c++17
+// Usage:   ./Lab2-3 [heap MB] [touched fraction]...
+//          (default: 256 MB heap, fractions 0, 0.01, 0.1, 0.5 and 1)
+//
+// Measures what copy-on-write really costs a forked child. The parent fills
+// a heap of the given size, then for each fraction forks a child that writes
+// one byte to that fraction of the heap's pages. For every child it reports
+// the minor page faults and time the writes took, and RSS/PSS/private memory
+// from /proc/self/smaps_rollup for both processes while the child is alive.
+//
+// Sizing a fork-based worker pool: each worker costs roughly its private
+// dirty memory, while PSS splits the still-shared pages among the sharers.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>          // /proc/self/smaps_rollup
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>         // fork(), pipe(), sysconf()
+#include <sys/mman.h>       // mmap(), madvise()
+#include <sys/resource.h>   // getrusage() for minor faults
+#include <sys/wait.h>       // waitpid()
+
+using namespace std;
+
+// Memory figures in kB, as /proc/<pid>/smaps_rollup reports them.
+struct MemoryRollup {
+    long rss = 0;
+    long pss = 0;
+    long shared = 0;        // Shared_Clean + Shared_Dirty
+    long private_dirty = 0;
+    bool valid = false;
+};
+
+MemoryRollup readRollup(pid_t pid) {
+    MemoryRollup rollup;
+    ifstream in(pid == 0 ? string("/proc/self/smaps_rollup") : "/proc/" + to_string(pid) + "/smaps_rollup");
+    string line;
+    while (getline(in, line)) {
+        istringstream fields(line);
+        string key;
+        long kb = 0;
+        if (!(fields >> key >> kb)) continue;
+        if (key == "Rss:") rollup.rss = kb;
+        else if (key == "Pss:") rollup.pss = kb;
+        else if (key == "Shared_Clean:" || key == "Shared_Dirty:") rollup.shared += kb;
+        else if (key == "Private_Dirty:") rollup.private_dirty = kb;
+        rollup.valid = true;
+    }
+    return rollup;
+}
+
+long minorFaults() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+// What the child sends back through the pipe once its writes are done.
+struct ChildReport {
+    long pages_touched;
+    long minor_faults;
+    double touch_ms;
+    MemoryRollup before;
+    MemoryRollup after;
+};
+
+struct CowResult {
+    double fork_ms;
+    ChildReport child;
+    MemoryRollup parent;    // read while the child is still alive
+};
+
+bool readAll(int fd, void* buf, size_t size) {
+    char* p = static_cast<char*>(buf);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+// Touches fraction of the heap's pages in a forked child, spread evenly
+// over the heap so that every part of it is represented.
+bool measureFork(char* heap, long pages, long page_size, double fraction, CowResult& result) {
+    int report_pipe[2], release_pipe[2];
+    if (pipe(report_pipe) < 0) return false;
+    if (pipe(release_pipe) < 0) {
+        close(report_pipe[0]);
+        close(report_pipe[1]);
+        return false;
+    }
+
+    auto before_fork = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        for (int fd : {report_pipe[0], report_pipe[1], release_pipe[0], release_pipe[1]}) close(fd);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(report_pipe[0]);
+        close(release_pipe[1]);
+
+        ChildReport report = {};
+        report.before = readRollup(0);
+        report.pages_touched = static_cast<long>(pages * fraction);
+
+        long faults = minorFaults();
+        auto start = chrono::steady_clock::now();
+        for (long k = 0; k < report.pages_touched; ++k) {
+            long page = k * pages / report.pages_touched;
+            heap[page * page_size] += 1;   // Copy-on-Write happens here
+        }
+        report.touch_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        report.minor_faults = minorFaults() - faults;
+        report.after = readRollup(0);
+
+        if (write(report_pipe[1], &report, sizeof(report)) != sizeof(report)) _exit(1);
+        // Stay alive until the parent has read its own rollup, so the
+        // pages the child has not touched are still counted as shared.
+        char done;
+        if (read(release_pipe[0], &done, 1) < 0) _exit(1);
+        _exit(0);
+    }
+
+    result.fork_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - before_fork).count();
+    close(report_pipe[1]);
+    close(release_pipe[0]);
+
+    bool ok = readAll(report_pipe[0], &result.child, sizeof(result.child));
+    result.parent = readRollup(0);
+
+    close(release_pipe[1]);
+    close(report_pipe[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    long heap_mb = argc > 1 ? atol(argv[1]) : 256;
+    vector<double> fractions;
+    for (int i = 2; i < argc; ++i) fractions.push_back(atof(argv[i]));
+    if (fractions.empty()) fractions = {0, 0.01, 0.1, 0.5, 1};
+    if (heap_mb <= 0) {
+        cerr << "Error: need a positive heap size" << endl;
+        return 1;
+    }
+    for (double f : fractions) {
+        if (f < 0 || f > 1) {
+            cerr << "Error: touched fractions must be between 0 and 1" << endl;
+            return 1;
+        }
+    }
+    if (!readRollup(0).valid) {
+        cerr << "Error: /proc/self/smaps_rollup is not available (Linux 4.14 or later)" << endl;
+        return 1;
+    }
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t bytes = static_cast<size_t>(heap_mb) * 1024 * 1024;
+    long pages = static_cast<long>(bytes / page_size);
+    char* heap = static_cast<char*>(mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (heap == MAP_FAILED) {
+        cerr << "Error: cannot map a " << heap_mb << " MB heap" << endl;
+        return 1;
+    }
+    // Regular pages only, so that one write is one fault and one page copied.
+    madvise(heap, bytes, MADV_NOHUGEPAGE);
+    memset(heap, 1, bytes);
+
+    cout << "==================================================" << endl;
+    cout << "  COPY-ON-WRITE COST OF A FORKED CHILD" << endl;
+    cout << "==================================================" << endl;
+    MemoryRollup alone = readRollup(0);
+    cout << "Parent heap: " << heap_mb << " MB (" << pages << " pages of " << page_size / 1024 << " kB)" << endl;
+    cout << "Parent alone: RSS " << alone.rss / 1024 << " MB, PSS " << alone.pss / 1024 << " MB" << endl;
+
+    cout << "\nAll memory in MB; RSS/PSS/private are read while the child is alive." << endl;
+    cout << setw(9) << "touched" << setw(10) << "pages" << setw(10) << "faults" << setw(10) << "fork ms"
+         << setw(10) << "touch ms" << setw(10) << "us/fault"
+         << setw(11) << "child RSS" << setw(8) << "PSS" << setw(9) << "private"
+         << setw(12) << "parent PSS" << setw(9) << "private" << endl;
+    cout << string(108, '-') << endl;
+
+    for (double fraction : fractions) {
+        CowResult r;
+        if (!measureFork(heap, pages, page_size, fraction, r)) {
+            cerr << "Error: fork measurement failed: " << strerror(errno) << endl;
+            munmap(heap, bytes);
+            return 1;
+        }
+        const ChildReport& c = r.child;
+        double per_fault = c.minor_faults ? c.touch_ms * 1000 / c.minor_faults : 0;
+        cout << fixed << setprecision(1)
+             << setw(8) << fraction * 100 << "%" << setw(10) << c.pages_touched << setw(10) << c.minor_faults
+             << setw(10) << r.fork_ms << setw(10) << c.touch_ms << setprecision(2) << setw(10) << per_fault
+             << setprecision(1)
+             << setw(11) << c.after.rss / 1024.0 << setw(8) << c.after.pss / 1024.0
+             << setw(9) << c.after.private_dirty / 1024.0
+             << setw(12) << r.parent.pss / 1024.0 << setw(9) << r.parent.private_dirty / 1024.0 << endl;
+    }
+
+    cout << "\nA pool of N forked workers that each write fraction f of the heap" << endl;
+    cout << "needs about heap + N * f * heap of memory: the child's private column." << endl;
+
+    munmap(heap, bytes);
+    return 0;
+}
@@ -0,0 +1,242 @@
+// File: spawner.h
+// Starting and reaping many child processes on Linux.
+//
+// spawnProcess starts a program in one of four ways:
+//   fork         copies the parent's page tables (copy-on-write), then execs.
+//                The copy grows with the parent's resident memory.
+//   vfork        borrows the parent's address space until the child execs;
+//                the parent is suspended meanwhile. Nothing is copied.
+//   posix_spawn  the C library's spawn, which on Linux glibc is itself a
+//                clone(CLONE_VM | CLONE_VFORK).
+//   clone        clone(CLONE_VM | CLONE_VFORK) done by hand on a small
+//                separate stack, which is what the other two do underneath.
+//
+// Launcher keeps a bounded number of children in flight and reaps them
+// either with waitid(P_ALL), whichever child exits first, or through pidfds
+// (pidfd_open, poll, then waitid(P_PIDFD)), which lets a program wait for
+// exactly its own children alongside other file descriptors.
+
+#ifndef SPAWNER_H
+#define SPAWNER_H
+
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+extern char** environ;
+
+enum class SpawnMethod { FORK, VFORK, POSIX_SPAWN, CLONE };
+enum class ReapMethod { WAITID, PIDFD };
+
+inline const char* spawnMethodName(SpawnMethod method) {
+    switch (method) {
+        case SpawnMethod::FORK: return "fork";
+        case SpawnMethod::VFORK: return "vfork";
+        case SpawnMethod::POSIX_SPAWN: return "posix_spawn";
+        case SpawnMethod::CLONE: return "clone(CLONE_VM)";
+    }
+    return "?";
+}
+
+inline const char* reapMethodName(ReapMethod method) {
+    return method == ReapMethod::WAITID ? "waitid" : "pidfd";
+}
+
+namespace spawner_detail {
+
+struct ExecArgs {
+    const char* path;
+    char* const* argv;
+};
+
+// Runs on the clone child's stack, sharing the parent's memory, so like a
+// vfork child it may only exec or _exit.
+inline int execChild(void* arg) {
+    const ExecArgs* args = static_cast<const ExecArgs*>(arg);
+    execve(args->path, args->argv, environ);
+    _exit(127);
+}
+
+// CLONE_VFORK suspends only the calling thread until the child has exec'd,
+// so each thread needs a stack of its own but can reuse it for every clone
+// it makes. The stack is unmapped when the thread exits.
+struct CloneStack {
+    static constexpr size_t SIZE = 64 * 1024;
+    char* base;
+
+    CloneStack() {
+        void* p = mmap(nullptr, SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("cannot map a clone stack");
+        base = static_cast<char*>(p);
+    }
+    ~CloneStack() { munmap(base, SIZE); }
+    CloneStack(const CloneStack&) = delete;
+    CloneStack& operator=(const CloneStack&) = delete;
+};
+
+inline char* cloneStackTop() {
+    thread_local CloneStack stack;
+    return stack.base + CloneStack::SIZE;
+}
+
+}  // namespace spawner_detail
+
+// Starts path with argv (argv[0] included, null-terminated) and returns the
+// child's pid. A child whose exec fails exits with status 127.
+inline pid_t spawnProcess(SpawnMethod method, const char* path, char* const argv[]) {
+    pid_t pid = -1;
+    switch (method) {
+        case SpawnMethod::FORK:
+            pid = fork();
+            if (pid == 0) {
+                execve(path, argv, environ);
+                _exit(127);
+            }
+            break;
+        case SpawnMethod::VFORK:
+            pid = vfork();
+            if (pid == 0) {
+                execve(path, argv, environ);
+                _exit(127);
+            }
+            break;
+        case SpawnMethod::POSIX_SPAWN: {
+            int err = posix_spawn(&pid, path, nullptr, nullptr, argv, environ);
+            if (err != 0) {
+                errno = err;
+                pid = -1;
+            }
+            break;
+        }
+        case SpawnMethod::CLONE: {
+            spawner_detail::ExecArgs args = {path, argv};
+            pid = clone(spawner_detail::execChild, spawner_detail::cloneStackTop(),
+                        CLONE_VM | CLONE_VFORK | SIGCHLD, &args);
+            break;
+        }
+    }
+    if (pid < 0) throw std::runtime_error(std::string(spawnMethodName(method)) + " failed: " + std::strerror(errno));
+    return pid;
+}
+
+inline int pidfdOpen(pid_t pid) {
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+}
+
+// Whether this kernel supports pidfds.
+inline bool pidfdSupported() {
+    int fd = pidfdOpen(getpid());
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+}
+
+// Starts children with at most max_in_flight alive at once; launch reaps
+// before it starts one more. Every child must exit with status 0.
+class Launcher {
+private:
+    SpawnMethod spawn_method;
+    ReapMethod reap_method;
+    size_t max_in_flight;
+    size_t in_flight = 0;
+    std::vector<struct pollfd> pidfds;   // PIDFD only: one per live child
+    long long failures = 0;
+
+    // waitid(P_PIDFD) needs glibc 2.36 headers; the value is fixed by the kernel ABI.
+    static constexpr idtype_t ID_PIDFD = static_cast<idtype_t>(3);
+
+    void noteExit(const siginfo_t& info) {
+        if (info.si_code != CLD_EXITED || info.si_status != 0) ++failures;
+        --in_flight;
+    }
+
+    // Reaps at least one child, blocking until one exits.
+    void reapSome() {
+        if (reap_method == ReapMethod::WAITID) {
+            siginfo_t info;
+            if (waitid(P_ALL, 0, &info, WEXITED) != 0) throw std::runtime_error("waitid failed");
+            noteExit(info);
+            return;
+        }
+        // With no pidfd to wait on, poll would block forever.
+        if (pidfds.empty()) throw std::runtime_error("no child to reap");
+        while (poll(pidfds.data(), pidfds.size(), -1) < 0) {
+            if (errno != EINTR) throw std::runtime_error("poll failed");
+        }
+        for (size_t i = 0; i < pidfds.size();) {
+            if (!pidfds[i].revents) {
+                ++i;
+                continue;
+            }
+            siginfo_t info;
+            if (waitid(ID_PIDFD, static_cast<id_t>(pidfds[i].fd), &info, WEXITED) != 0) {
+                throw std::runtime_error("waitid(P_PIDFD) failed");
+            }
+            noteExit(info);
+            close(pidfds[i].fd);
+            pidfds[i] = pidfds.back();
+            pidfds.pop_back();
+        }
+    }
+
+public:
+    Launcher(SpawnMethod spawn, ReapMethod reap, size_t limit = 64)
+        : spawn_method(spawn), reap_method(reap), max_in_flight(limit ? limit : 1) {
+        if (reap == ReapMethod::PIDFD && !pidfdSupported()) throw std::runtime_error("pidfd_open is not supported");
+    }
+
+    Launcher(const Launcher&) = delete;
+    Launcher& operator=(const Launcher&) = delete;
+
+    ~Launcher() {
+        try {
+            reapAll();
+        } catch (...) {
+        }
+    }
+
+    // Reaps until another child may start; launch does this itself, so
+    // call it first only to keep reaping out of a timed launch.
+    void makeRoom() {
+        while (in_flight >= max_in_flight) reapSome();
+    }
+
+    pid_t launch(const char* path, char* const argv[]) {
+        makeRoom();
+        pid_t pid = spawnProcess(spawn_method, path, argv);
+        if (reap_method == ReapMethod::PIDFD) {
+            // The child counts as in flight only once there is a pidfd to
+            // reap it through; without one, reap it here.
+            int fd = pidfdOpen(pid);
+            if (fd < 0) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+                throw std::runtime_error("pidfd_open failed");
+            }
+            pidfds.push_back({fd, POLLIN, 0});
+        }
+        ++in_flight;
+        return pid;
+    }
+
+    void reapAll() {
+        while (in_flight > 0) reapSome();
+    }
+
+    // Children that exited with a nonzero status or were killed.
+    long long failed() const { return failures; }
+};
+
+#endif // SPAWNER_H
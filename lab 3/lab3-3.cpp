@@ -1,14 +1,16 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
-std::mutex mtx;
-int counter = 0;
+#include "sharded_counter.h"
+std::mutex print_mtx;
+ShardedCounter counter;
 void increment(int id) {
 for (int i = 0; i < 5; i++) {
-mtx.lock();
-counter++;
-std::cout << "Thread " << id << " incremented counter to " << counter << "\n";
-mtx.unlock();
+counter.add(1);
+{
+std::lock_guard<std::mutex> lock(print_mtx);
+std::cout << "Thread " << id << " made increment " << i + 1 << " of 5\n";
+}
 std::this_thread::sleep_for(std::chrono::milliseconds(300));
 }
 }
@@ -17,6 +19,6 @@ std::thread t1(increment, 1);
 std::thread t2(increment, 2);
 t1.join();
 t2.join();
-std::cout << "Final counter = " << counter << "\n";
+std::cout << "Final counter = " << counter.read() << "\n";
 return 0;
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+// File: lab3-6.cpp
+// Compile: g++ -O2 -pthread -o lab3-6 lab3-6.cpp -std=c++17
+// Usage:   ./lab3-6 [tasks] [threads]
+//          (default: 1000000 tasks, one thread per CPU)
+//
+// Runs the same number of tiny tasks four ways and reports tasks per second:
+//   thread per task   what lab3-2/3/5 do: start a std::thread, join it
+//   pool submit       ThreadPool::submit from main, one future per task
+//   pool post         ThreadPool::post from main, a countdown instead of futures
+//   pool fork-join    one root task splits the range in halves on the workers,
+//                     so idle workers only get work by stealing it
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <cstdlib>
+
+#include "thread_pool.h"
+
+// The task body: small enough that the scheduling overhead dominates.
+std::atomic<long long> checksum{0};
+
+void tinyTask(long long i) {
+    checksum.fetch_add(i * i % 7, std::memory_order_relaxed);
+}
+
+long long expectedChecksum(long long tasks) {
+    long long sum = 0;
+    for (long long i = 0; i < tasks; ++i) sum += i * i % 7;
+    return sum;
+}
+
+// Counts finished tasks and wakes the waiting thread after the last one.
+class Countdown {
+private:
+    std::atomic<long long> left;
+    std::promise<void> done;
+
+public:
+    explicit Countdown(long long n) : left(n) {}
+    void arrive() {
+        if (left.fetch_sub(1, std::memory_order_acq_rel) == 1) done.set_value();
+    }
+    void wait() { done.get_future().wait(); }
+};
+
+void runThreadPerTask(long long tasks, size_t threads) {
+    // Start threads a few at a time, as many as the pool would have, so the
+    // comparison is against the same parallelism rather than 1M live threads.
+    std::vector<std::thread> batch;
+    batch.reserve(threads);
+    for (long long i = 0; i < tasks;) {
+        for (size_t t = 0; t < threads && i < tasks; ++t, ++i) batch.emplace_back(tinyTask, i);
+        for (std::thread& t : batch) t.join();
+        batch.clear();
+    }
+}
+
+void runPoolSubmit(ThreadPool& pool, long long tasks) {
+    std::vector<std::future<void>> results;
+    results.reserve(tasks);
+    for (long long i = 0; i < tasks; ++i) results.push_back(pool.submit(tinyTask, i));
+    for (std::future<void>& f : results) f.get();
+}
+
+void runPoolPost(ThreadPool& pool, long long tasks) {
+    Countdown countdown(tasks);
+    for (long long i = 0; i < tasks; ++i) {
+        pool.post([i, &countdown] {
+            tinyTask(i);
+            countdown.arrive();
+        });
+    }
+    countdown.wait();
+}
+
+void splitRange(ThreadPool& pool, long long begin, long long end, Countdown& countdown) {
+    while (end - begin > 1) {
+        long long mid = begin + (end - begin) / 2;
+        pool.post([&pool, mid, end, &countdown] { splitRange(pool, mid, end, countdown); });
+        end = mid;
+    }
+    tinyTask(begin);
+    countdown.arrive();
+}
+
+void runPoolForkJoin(ThreadPool& pool, long long tasks) {
+    Countdown countdown(tasks);
+    pool.post([&pool, tasks, &countdown] { splitRange(pool, 0, tasks, countdown); });
+    countdown.wait();
+}
+
+int main(int argc, char* argv[]) {
+    long long tasks = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    size_t threads = argc > 2 ? std::atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (tasks <= 0 || threads == 0) {
+        std::cerr << "Error: need a positive number of tasks and threads" << std::endl;
+        return 1;
+    }
+    long long expected = expectedChecksum(tasks);
+
+    std::cout << tasks << " tiny tasks, " << threads << " threads\n\n";
+    std::cout << std::left << std::setw(20) << "Method" << std::right << std::setw(12) << "seconds"
+              << std::setw(14) << "tasks/s" << std::setw(10) << "steals" << "\n";
+    std::cout << std::string(56, '-') << "\n";
+
+    ThreadPool pool(threads);
+    struct Method {
+        const char* name;
+        std::function<void()> run;
+    } methods[] = {
+        {"thread per task", [&] { runThreadPerTask(tasks, threads); }},
+        {"pool submit", [&] { runPoolSubmit(pool, tasks); }},
+        {"pool post", [&] { runPoolPost(pool, tasks); }},
+        {"pool fork-join", [&] { runPoolForkJoin(pool, tasks); }},
+    };
+
+    for (Method& method : methods) {
+        checksum = 0;
+        long long steals_before = pool.steals();
+        auto start = std::chrono::steady_clock::now();
+        method.run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::fixed << std::setprecision(3) << std::left << std::setw(20) << method.name << std::right
+                  << std::setw(12) << seconds << std::setprecision(0) << std::setw(14) << tasks / seconds
+                  << std::setw(10) << pool.steals() - steals_before;
+        if (checksum != expected) std::cout << "  (wrong checksum)";
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+// File: thread_pool.h
+// A fixed-size pool of std::threads with one task deque per worker and
+// work stealing.
+//
+// A worker pushes and pops tasks at the back of its own deque (newest
+// first, which keeps recently touched data in cache) and, when that runs
+// dry, steals from the front of the other workers' deques (oldest first,
+// which tends to take the biggest pieces of a divided-up job). Tasks
+// submitted from outside the pool are dealt round robin to the deques.
+// Idle workers sleep on a condition variable rather than spin.
+//
+// submit() returns a std::future for the task's result (or its exception);
+// post() is the cheaper fire-and-forget form. A task must not block on the
+// future of another task in the same pool: with every worker waiting, nobody
+// would be left to run it.
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+private:
+    // A move-only type-erased callable, so a std::packaged_task can be
+    // queued directly (std::function insists on copyable targets).
+    class Task {
+    private:
+        struct Callable {
+            virtual ~Callable() = default;
+            virtual void call() = 0;
+        };
+        template <typename F>
+        struct Holder : Callable {
+            F fn;
+            template <typename G>
+            explicit Holder(G&& g) : fn(std::forward<G>(g)) {}
+            void call() override { fn(); }
+        };
+        std::unique_ptr<Callable> callable;
+
+    public:
+        Task() = default;
+        template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Task>::value>>
+        Task(F&& f) : callable(new Holder<std::decay_t<F>>(std::forward<F>(f))) {}
+        void operator()() { callable->call(); }
+    };
+
+    struct alignas(64) WorkQueue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> pending{0};       // queued, not yet taken
+    std::atomic<size_t> next_queue{0};    // round robin for outside submitters
+    std::atomic<long long> steal_count{0};
+
+    std::mutex sleep_mtx;
+    std::condition_variable wake;
+    std::atomic<int> sleepers{0};
+    bool stopping = false;                // guarded by sleep_mtx
+
+    // Which pool and deque the calling thread works for, if any.
+    static inline thread_local ThreadPool* current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+
+    void enqueue(Task task) {
+        size_t index = current_pool == this ? current_index
+                                            : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mtx);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        // Paired with the sleeper check in workerLoop: either the sleeper
+        // sees the new count or we see the sleeper and wake it.
+        pending.fetch_add(1);
+        if (sleepers.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            wake.notify_one();
+        }
+    }
+
+    bool popOwn(size_t index, Task& task) {
+        WorkQueue& q = *queues[index];
+        std::lock_guard<std::mutex> lock(q.mtx);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, Task& task) {
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkQueue& q = *queues[(thief + i) % queues.size()];
+            std::unique_lock<std::mutex> lock(q.mtx, std::try_to_lock);
+            if (!lock.owns_lock() || q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            steal_count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        current_pool = this;
+        current_index = index;
+        Task task;
+        while (true) {
+            if (popOwn(index, task) || steal(index, task)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                task();
+                task = Task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mtx);
+            sleepers.fetch_add(1);
+            wake.wait(lock, [this] { return pending.load() > 0 || stopping; });
+            sleepers.fetch_sub(1);
+            // On shutdown, leave only once every queued task has run.
+            if (stopping && pending.load() == 0) return;
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+        if (threads == 0) threads = 1;
+        for (size_t i = 0; i < threads; ++i) queues.emplace_back(new WorkQueue);
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs whatever is still queued, then joins the workers.
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using Result = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        std::packaged_task<Result()> task(
+            [fn = std::forward<F>(f), tup = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(fn), std::move(tup));
+            });
+        std::future<Result> result = task.get_future();
+        enqueue(Task(std::move(task)));
+        return result;
+    }
+
+    template <typename F>
+    void post(F&& f) {
+        enqueue(Task(std::forward<F>(f)));
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // Tasks taken from another worker's deque so far.
+    long long steals() const { return steal_count.load(std::memory_order_relaxed); }
+};
+
+#endif // THREAD_POOL_H
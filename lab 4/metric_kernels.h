@@ -0,0 +1,333 @@
+// File: metric_kernels.h
+// Fused single-pass reductions over scheduler result columns.
+//
+// One pass over K int columns produces, for each column, a 64-bit sum, the
+// min, the max and a log-linear histogram in the style of HdrHistogram:
+// values below 32 get a bucket each, and every power of two above that is
+// split into 16 equal buckets, so a percentile read from the histogram is
+// within 1/16 of the true value. Summaries of disjoint data merge by adding
+// buckets, so percentiles of a large or parallel run never need a sort.
+// AVX2 and SSE4.1 versions are compiled with per-function target attributes
+// and picked at runtime, so the same binary still runs on CPUs without them.
+
+#ifndef METRIC_KERNELS_H
+#define METRIC_KERNELS_H
+
+#include <vector>
+#include <cstddef>
+#include <climits>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define METRICS_X86_KERNELS 1
+#endif
+
+const int HISTOGRAM_SUB_BITS = 4;                        // 16 buckets per power of two
+const int HISTOGRAM_LINEAR = 2 << HISTOGRAM_SUB_BITS;    // values below this are exact
+const int HISTOGRAM_BUCKETS = (30 - HISTOGRAM_SUB_BITS) * (HISTOGRAM_LINEAR / 2) + HISTOGRAM_LINEAR;
+
+inline int bitWidth(int v) {
+    return v <= 0 ? 0 : 32 - __builtin_clz(static_cast<unsigned>(v));
+}
+
+// Values <= 0 share bucket 0. Above the linear range a value keeps its top
+// 1 + HISTOGRAM_SUB_BITS bits: v >> shift lies in [16, 32) and each shift
+// step adds 16 buckets.
+inline int histogramBucket(int v) {
+    if (v < HISTOGRAM_LINEAR) return std::max(v, 0);
+    int shift = bitWidth(v) - (HISTOGRAM_SUB_BITS + 1);
+    return shift * (HISTOGRAM_LINEAR / 2) + (v >> shift);
+}
+
+// Largest value that lands in bucket b.
+inline long long histogramBucketTop(int b) {
+    if (b < HISTOGRAM_LINEAR) return b;
+    int shift = b / (HISTOGRAM_LINEAR / 2) - 1;
+    long long top_bits = b % (HISTOGRAM_LINEAR / 2) + HISTOGRAM_LINEAR / 2;
+    return ((top_bits + 1) << shift) - 1;
+}
+
+struct ColumnSummary {
+    long long count = 0;
+    long long sum = 0;
+    int min = INT_MAX;
+    int max = INT_MIN;
+    unsigned long long histogram[HISTOGRAM_BUCKETS] = {};
+
+    void add(int v) {
+        ++count;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+        ++histogram[histogramBucket(v)];
+    }
+
+    // Folds in a summary of other values, e.g. one collected on another CPU.
+    void merge(const ColumnSummary& other) {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) histogram[b] += other.histogram[b];
+    }
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    // Upper bound of the histogram bucket holding the p-th percentile
+    // (HdrHistogram's "highest equivalent value"), capped at the maximum.
+    long long percentileUpperBound(double p) const {
+        if (count == 0) return 0;
+        // Nearest rank: the smallest value with at least p% of samples at or below it.
+        unsigned long long rank = static_cast<unsigned long long>(std::ceil(p / 100.0 * count));
+        rank = std::max(1ULL, std::min(rank, static_cast<unsigned long long>(count)));
+        unsigned long long seen = 0;
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            seen += histogram[b];
+            if (seen >= rank) return std::max<long long>(min, std::min<long long>(max, histogramBucketTop(b)));
+        }
+        return max;
+    }
+};
+
+inline void finishSummary(ColumnSummary& s, size_t n) {
+    s.count += static_cast<long long>(n);
+}
+
+inline void mergeLaneHistograms(ColumnSummary& s, const unsigned long long* lanes, int copies) {
+    for (int copy = 0; copy < copies; ++copy) {
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            s.histogram[b] += lanes[copy * HISTOGRAM_BUCKETS + b];
+        }
+    }
+}
+
+template <int K>
+void summarizeScalar(const int* const* columns, size_t n, ColumnSummary* out) {
+    for (int k = 0; k < K; ++k) {
+        const int* col = columns[k];
+        ColumnSummary& s = out[k];
+        for (size_t i = 0; i < n; ++i) {
+            int v = col[i];
+            s.sum += v;
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+            ++s.histogram[histogramBucket(v)];
+        }
+        finishSummary(s, n);
+    }
+}
+
+#ifdef METRICS_X86_KERNELS
+
+// histogramBucket for each lane. Smearing the top set bit downwards and
+// shifting right by 5 gives a mask of everything below the top five bits;
+// with those cleared the int->float conversion is exact, and the float's
+// exponent and top four mantissa bits (bits 19 and up) are the bucket index
+// plus a constant bias. Lanes below the linear range are blended in as is.
+const int HISTOGRAM_FLOAT_BIAS = (127 + HISTOGRAM_SUB_BITS - 1) << HISTOGRAM_SUB_BITS;
+
+__attribute__((target("avx2")))
+inline __m256i histogramBucketAvx2(__m256i v) {
+    __m256i smear = _mm256_or_si256(v, _mm256_srli_epi32(v, 1));
+    smear = _mm256_or_si256(smear, _mm256_srli_epi32(smear, 2));
+    smear = _mm256_or_si256(smear, _mm256_srli_epi32(smear, 4));
+    smear = _mm256_or_si256(smear, _mm256_srli_epi32(smear, 8));
+    smear = _mm256_or_si256(smear, _mm256_srli_epi32(smear, 16));
+    __m256i top = _mm256_andnot_si256(_mm256_srli_epi32(smear, HISTOGRAM_SUB_BITS + 1), v);
+    __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(top)), 23 - HISTOGRAM_SUB_BITS);
+    __m256i logarithmic = _mm256_sub_epi32(bits, _mm256_set1_epi32(HISTOGRAM_FLOAT_BIAS));
+    __m256i linear = _mm256_max_epi32(v, _mm256_setzero_si256());
+    __m256i large = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(HISTOGRAM_LINEAR - 1));
+    return _mm256_blendv_epi8(linear, logarithmic, large);
+}
+
+template <int K>
+__attribute__((target("avx2")))
+void summarizeAvx2(const int* const* columns, size_t n, ColumnSummary* out) {
+    __m256i sum_lo[K], sum_hi[K], vmin[K], vmax[K];
+    for (int k = 0; k < K; ++k) {
+        sum_lo[k] = sum_hi[k] = _mm256_setzero_si256();
+        vmin[k] = _mm256_set1_epi32(INT_MAX);
+        vmax[k] = _mm256_set1_epi32(INT_MIN);
+    }
+
+    // Neighbouring values usually land in the same bucket; giving every lane
+    // its own copy of the histogram keeps the increments independent.
+    std::vector<unsigned long long> lanes(static_cast<size_t>(K) * 8 * HISTOGRAM_BUCKETS, 0);
+    const __m256i lane_offset = _mm256_setr_epi32(0, 1 * HISTOGRAM_BUCKETS, 2 * HISTOGRAM_BUCKETS,
+                                                  3 * HISTOGRAM_BUCKETS, 4 * HISTOGRAM_BUCKETS,
+                                                  5 * HISTOGRAM_BUCKETS, 6 * HISTOGRAM_BUCKETS,
+                                                  7 * HISTOGRAM_BUCKETS);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int k = 0; k < K; ++k) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns[k] + i));
+            sum_lo[k] = _mm256_add_epi64(sum_lo[k], _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+            sum_hi[k] = _mm256_add_epi64(sum_hi[k], _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+            vmin[k] = _mm256_min_epi32(vmin[k], v);
+            vmax[k] = _mm256_max_epi32(vmax[k], v);
+
+            unsigned long long* hist = &lanes[static_cast<size_t>(k) * 8 * HISTOGRAM_BUCKETS];
+            __m256i slot = _mm256_add_epi32(histogramBucketAvx2(v), lane_offset);
+            __m128i low = _mm256_castsi256_si128(slot);
+            __m128i high = _mm256_extracti128_si256(slot, 1);
+            unsigned long long pair0 = _mm_cvtsi128_si64(low);
+            unsigned long long pair1 = _mm_extract_epi64(low, 1);
+            unsigned long long pair2 = _mm_cvtsi128_si64(high);
+            unsigned long long pair3 = _mm_extract_epi64(high, 1);
+            ++hist[pair0 & 0xffffffff];
+            ++hist[pair0 >> 32];
+            ++hist[pair1 & 0xffffffff];
+            ++hist[pair1 >> 32];
+            ++hist[pair2 & 0xffffffff];
+            ++hist[pair2 >> 32];
+            ++hist[pair3 & 0xffffffff];
+            ++hist[pair3 >> 32];
+        }
+    }
+
+    for (int k = 0; k < K; ++k) {
+        ColumnSummary& s = out[k];
+        alignas(32) long long sums[4];
+        alignas(32) int mins[8], maxs[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_add_epi64(sum_lo[k], sum_hi[k]));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(mins), vmin[k]);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(maxs), vmax[k]);
+        for (int lane = 0; lane < 4; ++lane) s.sum += sums[lane];
+        mergeLaneHistograms(s, &lanes[static_cast<size_t>(k) * 8 * HISTOGRAM_BUCKETS], 8);
+        for (int lane = 0; lane < 8; ++lane) {
+            s.min = std::min(s.min, mins[lane]);
+            s.max = std::max(s.max, maxs[lane]);
+        }
+        for (size_t j = i; j < n; ++j) {
+            int v = columns[k][j];
+            s.sum += v;
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+            ++s.histogram[histogramBucket(v)];
+        }
+        finishSummary(s, n);
+    }
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i histogramBucketSse(__m128i v) {
+    __m128i smear = _mm_or_si128(v, _mm_srli_epi32(v, 1));
+    smear = _mm_or_si128(smear, _mm_srli_epi32(smear, 2));
+    smear = _mm_or_si128(smear, _mm_srli_epi32(smear, 4));
+    smear = _mm_or_si128(smear, _mm_srli_epi32(smear, 8));
+    smear = _mm_or_si128(smear, _mm_srli_epi32(smear, 16));
+    __m128i top = _mm_andnot_si128(_mm_srli_epi32(smear, HISTOGRAM_SUB_BITS + 1), v);
+    __m128i bits = _mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(top)), 23 - HISTOGRAM_SUB_BITS);
+    __m128i logarithmic = _mm_sub_epi32(bits, _mm_set1_epi32(HISTOGRAM_FLOAT_BIAS));
+    __m128i linear = _mm_max_epi32(v, _mm_setzero_si128());
+    __m128i large = _mm_cmpgt_epi32(v, _mm_set1_epi32(HISTOGRAM_LINEAR - 1));
+    return _mm_blendv_epi8(linear, logarithmic, large);
+}
+
+template <int K>
+__attribute__((target("sse4.1")))
+void summarizeSse41(const int* const* columns, size_t n, ColumnSummary* out) {
+    __m128i sum_lo[K], sum_hi[K], vmin[K], vmax[K];
+    for (int k = 0; k < K; ++k) {
+        sum_lo[k] = sum_hi[k] = _mm_setzero_si128();
+        vmin[k] = _mm_set1_epi32(INT_MAX);
+        vmax[k] = _mm_set1_epi32(INT_MIN);
+    }
+
+    std::vector<unsigned long long> lanes(static_cast<size_t>(K) * 4 * HISTOGRAM_BUCKETS, 0);
+    const __m128i lane_offset = _mm_setr_epi32(0, HISTOGRAM_BUCKETS, 2 * HISTOGRAM_BUCKETS, 3 * HISTOGRAM_BUCKETS);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < K; ++k) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns[k] + i));
+            sum_lo[k] = _mm_add_epi64(sum_lo[k], _mm_cvtepi32_epi64(v));
+            sum_hi[k] = _mm_add_epi64(sum_hi[k], _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+            vmin[k] = _mm_min_epi32(vmin[k], v);
+            vmax[k] = _mm_max_epi32(vmax[k], v);
+
+            unsigned long long* hist = &lanes[static_cast<size_t>(k) * 4 * HISTOGRAM_BUCKETS];
+            __m128i slot = _mm_add_epi32(histogramBucketSse(v), lane_offset);
+            unsigned long long pair0 = _mm_cvtsi128_si64(slot);
+            unsigned long long pair1 = _mm_extract_epi64(slot, 1);
+            ++hist[pair0 & 0xffffffff];
+            ++hist[pair0 >> 32];
+            ++hist[pair1 & 0xffffffff];
+            ++hist[pair1 >> 32];
+        }
+    }
+
+    for (int k = 0; k < K; ++k) {
+        ColumnSummary& s = out[k];
+        alignas(16) long long sums[2];
+        alignas(16) int mins[4], maxs[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_add_epi64(sum_lo[k], sum_hi[k]));
+        _mm_store_si128(reinterpret_cast<__m128i*>(mins), vmin[k]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxs), vmax[k]);
+        s.sum += sums[0] + sums[1];
+        mergeLaneHistograms(s, &lanes[static_cast<size_t>(k) * 4 * HISTOGRAM_BUCKETS], 4);
+        for (int lane = 0; lane < 4; ++lane) {
+            s.min = std::min(s.min, mins[lane]);
+            s.max = std::max(s.max, maxs[lane]);
+        }
+        for (size_t j = i; j < n; ++j) {
+            int v = columns[k][j];
+            s.sum += v;
+            s.min = std::min(s.min, v);
+            s.max = std::max(s.max, v);
+            ++s.histogram[histogramBucket(v)];
+        }
+        finishSummary(s, n);
+    }
+}
+
+#endif // METRICS_X86_KERNELS
+
+enum class MetricsKernel { SCALAR, SSE41, AVX2 };
+
+inline const char* metricsKernelName(MetricsKernel kernel) {
+    switch (kernel) {
+        case MetricsKernel::SCALAR: return "scalar";
+        case MetricsKernel::SSE41: return "SSE4.1";
+        case MetricsKernel::AVX2: return "AVX2";
+    }
+    return "?";
+}
+
+inline MetricsKernel bestMetricsKernel() {
+#ifdef METRICS_X86_KERNELS
+    static const MetricsKernel best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return MetricsKernel::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return MetricsKernel::SSE41;
+        return MetricsKernel::SCALAR;
+    }();
+    return best;
+#else
+    return MetricsKernel::SCALAR;
+#endif
+}
+
+// Summarizes K equally long columns in one pass. Results are accumulated
+// into out[0..K), so a column can also be fed in several chunks.
+template <int K>
+void summarizeColumns(const int* const* columns, size_t n, ColumnSummary* out,
+                      MetricsKernel kernel = bestMetricsKernel()) {
+    switch (kernel) {
+#ifdef METRICS_X86_KERNELS
+        case MetricsKernel::AVX2:
+            summarizeAvx2<K>(columns, n, out);
+            return;
+        case MetricsKernel::SSE41:
+            summarizeSse41<K>(columns, n, out);
+            return;
+#endif
+        default:
+            summarizeScalar<K>(columns, n, out);
+            return;
+    }
+}
+
+#endif // METRIC_KERNELS_H
@@ -0,0 +1,212 @@
+// File: metrics.h
+// Scheduling metrics shared by the lab 4 scheduler programs.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+
+#include "process.h"
+#include "metric_kernels.h"
+
+class MetricsCalculator {
+private:
+    // Everything the metrics need is collected in one fused pass over the
+    // result columns; the columns themselves are not kept.
+    ColumnSummary completion;
+    ColumnSummary turnaround;
+    ColumnSummary waiting;
+    ColumnSummary response;
+    long long total_time = 0;
+    long long cpu_idle_time = 0;
+    std::vector<ColumnSummary> level_latency;
+    std::vector<long long> cpu_busy_time;   // multicore runs only
+    std::vector<long long> cpu_migrations;
+    long long deadline_jobs = 0;
+    long long deadline_misses = 0;
+    long long max_lateness = 0;
+    long long switch_overhead = 0;
+
+    long long cpuCount() const { return std::max<long long>(1, static_cast<long long>(cpu_busy_time.size())); }
+
+public:
+    // Clears the per-process summaries; the CPU idle time is set separately.
+    void reset() {
+        completion = turnaround = waiting = response = ColumnSummary();
+        total_time = 0;
+    }
+
+    // Folds another chunk of results into the running summaries, so a
+    // streamed run never needs all of its result columns in memory at once.
+    void addResults(const int* completion_col, const int* turnaround_col, const int* waiting_col,
+                    const int* response_col, size_t n) {
+        const int* columns[4] = {completion_col, turnaround_col, waiting_col, response_col};
+        ColumnSummary out[4] = {completion, turnaround, waiting, response};
+        summarizeColumns<4>(columns, n, out);
+        completion = out[0];
+        turnaround = out[1];
+        waiting = out[2];
+        response = out[3];
+        calculateTotalTime();
+    }
+
+    // Folds in summaries collected elsewhere, e.g. by another thread.
+    void merge(const MetricsCalculator& other) {
+        completion.merge(other.completion);
+        turnaround.merge(other.turnaround);
+        waiting.merge(other.waiting);
+        response.merge(other.response);
+        calculateTotalTime();
+    }
+
+    void setProcesses(const std::vector<Process>& procs) {
+        std::vector<int> completion_col(procs.size()), turnaround_col(procs.size()), waiting_col(procs.size());
+        std::vector<int> response_col(procs.size());
+        for (size_t i = 0; i < procs.size(); ++i) {
+            completion_col[i] = procs[i].completion_time;
+            turnaround_col[i] = procs[i].turnaround_time;
+            waiting_col[i] = procs[i].waiting_time;
+            response_col[i] = procs[i].response_time;
+        }
+        reset();
+        addResults(completion_col.data(), turnaround_col.data(), waiting_col.data(), response_col.data(),
+                   procs.size());
+    }
+
+    void setResult(const ScheduleResult& result) {
+        reset();
+        addResults(result.completion_time.data(), result.turnaround_time.data(),
+                   result.waiting_time.data(), result.response_time.data(), result.size());
+    }
+    
+    void calculateTotalTime() {
+        if (completion.count == 0) return;
+        total_time = completion.max;
+    }
+    
+    // Averaged over all CPUs; the idle time is summed over them too.
+    double getCPUUtilization() {
+        long long capacity = total_time * cpuCount();
+        long long busy_time = capacity - cpu_idle_time;
+        return (static_cast<double>(busy_time) / capacity) * 100.0;
+    }
+
+    double getCoreUtilization(size_t cpu) const {
+        return static_cast<double>(cpu_busy_time[cpu]) / total_time * 100.0;
+    }
+
+    // Share of CPU time spent switching rather than running processes;
+    // getCPUUtilization counts it as busy.
+    double getSwitchOverhead() const {
+        return static_cast<double>(switch_overhead) / (total_time * cpuCount()) * 100.0;
+    }
+
+    long long getMigrations() const {
+        long long total = 0;
+        for (long long m : cpu_migrations) total += m;
+        return total;
+    }
+    
+    double getThroughput() {
+        return static_cast<double>(completion.count) / total_time;
+    }
+    
+    double getAverageWaitingTime() {
+        return waiting.mean();
+    }
+    
+    double getAverageTurnaroundTime() {
+        return turnaround.mean();
+    }
+
+    const ColumnSummary& getWaitingSummary() const { return waiting; }
+    const ColumnSummary& getTurnaroundSummary() const { return turnaround; }
+    const ColumnSummary& getCompletionSummary() const { return completion; }
+    const ColumnSummary& getResponseSummary() const { return response; }
+    
+    // Time from arrival to first dispatch.
+    double getAverageResponseTime() {
+        return response.mean();
+    }
+    
+    void displayMetrics() {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n=== SCHEDULING METRICS ===\n";
+        std::cout << "CPU Utilization: " << getCPUUtilization() << "%\n";
+        std::cout << "Throughput: " << getThroughput() << " processes/unit time\n";
+        std::cout << "Average Waiting Time: " << getAverageWaitingTime() << " units\n";
+        std::cout << "Average Turnaround Time: " << getAverageTurnaroundTime() << " units\n";
+        std::cout << "Average Response Time: " << getAverageResponseTime() << " units\n";
+        std::cout << "Waiting Time (min/max): " << waiting.min << " / " << waiting.max << " units\n";
+        displayPercentiles();
+        for (size_t lvl = 0; lvl < level_latency.size(); ++lvl) {
+            const ColumnSummary& lat = level_latency[lvl];
+            if (lat.count == 0) continue;
+            std::cout << "Level " << lvl << " dispatch latency: avg " << lat.mean() << ", max " << lat.max
+                      << " units over " << lat.count << " dispatches\n";
+        }
+        if (switch_overhead > 0) {
+            std::cout << "Switch overhead: " << switch_overhead << " units (" << getSwitchOverhead()
+                      << "% of CPU time)\n";
+        }
+        if (deadline_jobs > 0) {
+            std::cout << "Deadline misses: " << deadline_misses << " of " << deadline_jobs
+                      << " jobs (max lateness " << max_lateness << " units)\n";
+        }
+        if (!cpu_busy_time.empty()) {
+            std::cout << "Migrations: " << getMigrations() << "\n";
+            for (size_t cpu = 0; cpu < cpu_busy_time.size(); ++cpu) {
+                std::cout << "CPU " << cpu << ": utilization " << getCoreUtilization(cpu) << "%, "
+                          << cpu_migrations[cpu] << " migrations in\n";
+            }
+        }
+    }
+    
+    // Percentiles come from the summaries' histograms and are exact up to
+    // 1/16 of the value (each is the top of its histogram bucket).
+    void displayPercentiles() {
+        static const struct { double p; const char* label; } percentiles[] = {
+            {50, "p50"}, {95, "p95"}, {99, "p99"}, {99.9, "p99.9"},
+        };
+        const struct { const char* name; const ColumnSummary& summary; } rows[] = {
+            {"Waiting", waiting}, {"Turnaround", turnaround}, {"Response", response},
+        };
+
+        std::cout << std::setw(12) << "Percentile";
+        for (const auto& pct : percentiles) std::cout << std::setw(9) << pct.label;
+        std::cout << std::setw(9) << "max" << "\n";
+        for (const auto& row : rows) {
+            std::cout << std::setw(12) << row.name;
+            for (const auto& pct : percentiles) std::cout << std::setw(9) << row.summary.percentileUpperBound(pct.p);
+            std::cout << std::setw(9) << row.summary.max << "\n";
+        }
+    }
+    
+    void setCPUIdleTime(long long idle) { cpu_idle_time = idle; }
+
+    // Time lost to context switches and cache refills (see SwitchCostModel).
+    void setSwitchOverhead(long long overhead) { switch_overhead = overhead; }
+
+    // Per-level dispatch latency from a multilevel queue (empty otherwise).
+    void setLevelLatency(const std::vector<ColumnSummary>& latency) { level_latency = latency; }
+
+    // Jobs with deadlines, how many completed late and by how much at worst.
+    void setDeadlineStats(long long jobs, long long misses, long long lateness) {
+        deadline_jobs = jobs;
+        deadline_misses = misses;
+        max_lateness = lateness;
+    }
+
+    long long getDeadlineMisses() const { return deadline_misses; }
+
+    // Per-CPU busy time and migrations from a multicore run (empty otherwise).
+    void setCoreUsage(const std::vector<long long>& busy, const std::vector<long long>& migrations) {
+        cpu_busy_time = busy;
+        cpu_migrations = migrations;
+    }
+};
+
+#endif // METRICS_H
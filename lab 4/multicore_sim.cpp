@@ -0,0 +1,138 @@
+// File: multicore_sim.cpp
+// Compile: g++ -O2 -pthread -o multicore_sim multicore_sim.cpp -std=c++17
+// Usage:   ./multicore_sim                          (textbook example on 2 CPUs, then an idle-pull check)
+//          ./multicore_sim <processes> [policy] [quantum]
+//          policy: fcfs, sjf, srtf, priority, priority-preemptive, rr, mlfq, cfs, edf, rm (default rr)
+//
+// The second form simulates a random workload on 1, 2, 4 and 8 CPUs, once
+// with a single host thread and once with one thread per host core, and
+// checks that both give the same schedule.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstdlib>
+
+#include "scheduler.h"
+
+void runExample() {
+    ProcessScheduler scheduler;
+    scheduler.addProcess(1, 0, 7, 3);
+    scheduler.addProcess(2, 2, 4, 1);
+    scheduler.addProcess(3, 4, 1, 4);
+    scheduler.addProcess(4, 5, 4, 2);
+    scheduler.addProcess(5, 5, 6, 0);
+    scheduler.addProcess(6, 6, 3, 1);
+
+    scheduler.options.multicore.cpus = 2;
+    scheduler.options.multicore.balance_interval = 4;
+    scheduler.options.multicore.migration_cost = 1;
+    scheduler.run(SchedulingPolicy::ROUND_ROBIN, 2);
+
+    std::cout << "Round Robin on 2 CPUs\n";
+    std::cout << "=====================\n";
+    scheduler.displayProcesses();
+
+    MetricsCalculator calc;
+    scheduler.exportMetrics(calc);
+    calc.displayMetrics();
+}
+
+// Four FCFS jobs on 2 CPUs: CPU 0 gets both short ones and runs dry at 10,
+// while the second long job still waits on CPU 1. CPU 0 must pull it as
+// soon as it is idle, so it starts at 16 (after the migration cost) and
+// finishes at 116, instead of waiting for CPU 1 and finishing at 200.
+int checkIdlePull() {
+    ProcessScheduler scheduler;
+    scheduler.addProcess(1, 0, 5, 0);
+    scheduler.addProcess(2, 0, 100, 0);
+    scheduler.addProcess(3, 0, 5, 0);
+    scheduler.addProcess(4, 0, 100, 0);
+    scheduler.options.multicore.cpus = 2;
+    scheduler.run(SchedulingPolicy::FCFS, 0);
+
+    int finished = scheduler.result.completion_time[3];
+    if (finished != 116) {
+        std::cerr << "Error: idle CPU did not pull queued work; process 4 finished at " << finished
+                  << ", expected 116" << std::endl;
+        return 1;
+    }
+    std::cout << "\nIdle pull check passed: process 4 finished at 116 on the CPU that ran dry\n";
+    return 0;
+}
+
+int runBenchmark(int count, SchedulingPolicy policy, int quantum) {
+    // About six CPUs' worth of work arrives, so small machines fall behind
+    // and large ones have room to spare.
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> gap(0, 10);
+    std::uniform_int_distribution<> burst(1, 60);
+    std::uniform_int_distribution<> prio(0, 31);
+
+    ProcessTable workload;
+    workload.reserve(count);
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(gen);
+        workload.add(i + 1, arrival, burst(gen), prio(gen));
+    }
+
+    int host_threads = static_cast<int>(std::thread::hardware_concurrency());
+    std::cout << "Simulating " << count << " processes under " << policyName(policy)
+              << " (" << host_threads << " host threads available)\n\n";
+    std::cout << std::setw(5) << "CPUs" << std::setw(12) << "1 thread" << std::setw(12) << "N threads"
+              << std::setw(14) << "makespan" << std::setw(8) << "util" << std::setw(12) << "migrations"
+              << std::setw(12) << "avg wait" << "\n";
+    std::cout << std::string(75, '-') << "\n";
+
+    for (int cpus : {1, 2, 4, 8}) {
+        ProcessScheduler serial, parallel;
+        serial.table = parallel.table = workload;
+        serial.options.multicore.cpus = parallel.options.multicore.cpus = cpus;
+        serial.options.multicore.threads = 1;
+
+        auto start = std::chrono::steady_clock::now();
+        serial.run(policy, quantum);
+        double serial_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        parallel.run(policy, quantum);
+        double parallel_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (serial.result.completion_time != parallel.result.completion_time) {
+            std::cerr << "Error: schedules differ between 1 and " << host_threads << " threads on "
+                      << cpus << " CPUs" << std::endl;
+            return 1;
+        }
+
+        MetricsCalculator calc;
+        parallel.exportMetrics(calc);
+        calc.setResult(parallel.result);
+
+        std::cout << std::setw(5) << cpus << std::fixed << std::setprecision(3)
+                  << std::setw(10) << serial_time << " s" << std::setw(10) << parallel_time << " s"
+                  << std::setw(14) << parallel.stats.makespan
+                  << std::setprecision(1) << std::setw(7) << calc.getCPUUtilization() << "%"
+                  << std::setw(12) << parallel.stats.migrations
+                  << std::setw(12) << calc.getAverageWaitingTime() << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        runExample();
+        return checkIdlePull();
+    }
+
+    SchedulingPolicy policy = SchedulingPolicy::ROUND_ROBIN;
+    if (argc > 2 && !parsePolicy(argv[2], policy)) {
+        std::cerr << "Error: unknown policy " << argv[2] << std::endl;
+        return 1;
+    }
+    int quantum = argc > 3 ? std::atoi(argv[3]) : 4;
+    return runBenchmark(std::atoi(argv[1]), policy, quantum);
+}
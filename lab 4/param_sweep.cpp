@@ -0,0 +1,230 @@
+// File: param_sweep.cpp
+// Compile: g++ -O2 -pthread -o param_sweep param_sweep.cpp -std=c++17
+// Usage:   ./param_sweep [options] <trace>...
+//          --policies rr,mlfq,...  policies to run (default: all)
+//          --quanta 2,4,8          quanta for rr and mlfq (default: 4)
+//          --cpus 1,2,4            simulated CPU counts (default: 1)
+//          --threads N             concurrent runs (default: one per host core)
+//          --switch-cost N         fixed cost of a context switch (default: 0)
+//          --cache-refill N        extra cost of a switch to a cold cache (default: 0)
+//          --cache-lifetime N      time away after which a process's cache is cold (default: 0)
+//          --out results.csv       where to write the table (default: stdout)
+//
+// Runs every combination of trace, policy, quantum and CPU count and writes
+// one CSV row of metrics per run. Each trace is loaded once and shared
+// read-only by all runs; a run only allocates its own result columns.
+// Policies that ignore the quantum run once per CPU count.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <cstdlib>
+
+#include "trace_loader.h"
+
+const SchedulingPolicy ALL_POLICIES[] = {
+    SchedulingPolicy::FCFS, SchedulingPolicy::SJF, SchedulingPolicy::SRTF,
+    SchedulingPolicy::PRIORITY, SchedulingPolicy::PRIORITY_PREEMPTIVE,
+    SchedulingPolicy::ROUND_ROBIN, SchedulingPolicy::MLFQ, SchedulingPolicy::CFS
+};
+
+struct SweepRun {
+    size_t trace;
+    SchedulingPolicy policy;
+    int quantum;   // 0 for policies that do not use one
+    int cpus;
+};
+
+struct SweepRow {
+    MetricsCalculator metrics;
+    SimulationStats stats;
+    double seconds = 0;
+};
+
+bool usesQuantum(SchedulingPolicy policy) {
+    return policy == SchedulingPolicy::ROUND_ROBIN || policy == SchedulingPolicy::MLFQ;
+}
+
+bool parseList(const std::string& text, std::vector<int>& out) {
+    std::stringstream ss(text);
+    std::string item;
+    out.clear();
+    while (std::getline(ss, item, ',')) {
+        int value = std::atoi(item.c_str());
+        if (value <= 0) return false;
+        out.push_back(value);
+    }
+    return !out.empty();
+}
+
+bool parsePolicies(const std::string& text, std::vector<SchedulingPolicy>& out) {
+    std::stringstream ss(text);
+    std::string item;
+    out.clear();
+    while (std::getline(ss, item, ',')) {
+        SchedulingPolicy policy;
+        if (!parsePolicy(item, policy)) return false;
+        out.push_back(policy);
+    }
+    return !out.empty();
+}
+
+SweepRow runOne(const ProcessTable& table, const SweepRun& run, const SwitchCostModel& costs) {
+    SweepRow row;
+    PolicyOptions options;
+    options.costs = &costs;
+    options.multicore.cpus = run.cpus;
+    options.multicore.threads = 1;   // the sweep already keeps every host core busy
+
+    auto start = std::chrono::steady_clock::now();
+    ScheduleResult result;
+    TableWorkload workload(table, result);
+    row.stats = simulatePolicy(workload, run.policy, run.quantum, options);
+    row.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    row.metrics.setResult(result);
+    row.metrics.setCPUIdleTime(row.stats.idle_time);
+    row.metrics.setSwitchOverhead(row.stats.switch_overhead);
+    row.metrics.setLevelLatency(row.stats.level_latency);
+    row.metrics.setCoreUsage(row.stats.cpu_busy_time, row.stats.cpu_migrations);
+    row.metrics.setDeadlineStats(row.stats.deadline_jobs, row.stats.deadline_misses, row.stats.max_lateness);
+    return row;
+}
+
+void writeTable(std::ostream& out, const std::vector<std::string>& traces,
+                const std::vector<SweepRun>& runs, std::vector<SweepRow>& rows) {
+    out << "trace,policy,quantum,cpus,processes,makespan,cpu_utilization,throughput,"
+           "avg_waiting,avg_turnaround,avg_response,p50_waiting,p99_waiting,p99.9_waiting,max_waiting,"
+           "p99_response,context_switches,"
+           "preemptions,migrations,switch_overhead,deadline_misses,sim_seconds\n";
+    out << std::fixed;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const SweepRun& run = runs[i];
+        SweepRow& row = rows[i];
+        const ColumnSummary& waiting = row.metrics.getWaitingSummary();
+        const ColumnSummary& response = row.metrics.getResponseSummary();
+        out << traces[run.trace] << ',' << policyName(run.policy) << ',';
+        if (run.quantum > 0) out << run.quantum;
+        out << ',' << run.cpus << ',' << waiting.count << ',' << row.stats.makespan << ','
+            << std::setprecision(2) << row.metrics.getCPUUtilization() << ','
+            << std::setprecision(6) << row.metrics.getThroughput() << ','
+            << std::setprecision(2) << row.metrics.getAverageWaitingTime() << ','
+            << row.metrics.getAverageTurnaroundTime() << ',' << row.metrics.getAverageResponseTime() << ','
+            << waiting.percentileUpperBound(50) << ',' << waiting.percentileUpperBound(99) << ','
+            << waiting.percentileUpperBound(99.9) << ',' << waiting.max << ','
+            << response.percentileUpperBound(99) << ','
+            << row.stats.context_switches << ',' << row.stats.preemptions << ','
+            << row.stats.migrations << ',' << std::setprecision(2) << row.metrics.getSwitchOverhead() << ','
+            << row.metrics.getDeadlineMisses() << ',' << std::setprecision(3) << row.seconds << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<SchedulingPolicy> policies(std::begin(ALL_POLICIES), std::end(ALL_POLICIES));
+    std::vector<int> quanta = {4};
+    std::vector<int> cpu_counts = {1};
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    std::string out_path;
+    std::vector<std::string> traces;
+    SwitchCostModel costs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--policies" && has_value) {
+            if (!parsePolicies(argv[++i], policies)) {
+                std::cerr << "Error: bad policy list " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if ((arg == "--quanta" || arg == "--cpus") && has_value) {
+            if (!parseList(argv[++i], arg == "--quanta" ? quanta : cpu_counts)) {
+                std::cerr << "Error: bad list " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--threads" && has_value) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--switch-cost" && has_value) {
+            costs.switch_cost = std::atoll(argv[++i]);
+        } else if (arg == "--cache-refill" && has_value) {
+            costs.cache_refill = std::atoll(argv[++i]);
+        } else if (arg == "--cache-lifetime" && has_value) {
+            costs.cache_lifetime = std::atoll(argv[++i]);
+        } else if (arg == "--out" && has_value) {
+            out_path = argv[++i];
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return 1;
+        } else {
+            traces.push_back(arg);
+        }
+    }
+    if (traces.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--policies p,...] [--quanta q,...] [--cpus n,...]"
+                  << " [--threads n] [--switch-cost n] [--cache-refill n] [--cache-lifetime n]"
+                  << " [--out file.csv] <trace>...\n";
+        return 1;
+    }
+
+    std::vector<ProcessTable> tables;
+    try {
+        for (const std::string& path : traces) tables.push_back(loadTrace(path));
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<SweepRun> runs;
+    for (size_t t = 0; t < tables.size(); ++t) {
+        for (SchedulingPolicy policy : policies) {
+            for (int cpus : cpu_counts) {
+                if (!usesQuantum(policy)) {
+                    runs.push_back({t, policy, 0, cpus});
+                    continue;
+                }
+                for (int quantum : quanta) runs.push_back({t, policy, quantum, cpus});
+            }
+        }
+    }
+
+    // Each worker claims the next unstarted run; rows land at their run's
+    // index, so the table comes out in the same order however runs finish.
+    std::vector<SweepRow> rows(runs.size());
+    std::atomic<size_t> next_run(0);
+    size_t finished = 0;
+    std::mutex progress_mutex;
+    threads = std::max(1, std::min(threads, static_cast<int>(runs.size())));
+
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&] {
+        for (size_t i = next_run++; i < runs.size(); i = next_run++) {
+            rows[i] = runOne(tables[runs[i].trace], runs[i], costs);
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            std::cerr << "\r" << ++finished << " / " << runs.size() << " runs" << std::flush;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cerr << "\r" << runs.size() << " runs on " << threads << " threads in "
+              << std::fixed << std::setprecision(3) << elapsed << " s\n";
+
+    if (out_path.empty()) {
+        writeTable(std::cout, traces, runs, rows);
+        return 0;
+    }
+    std::ofstream out(out_path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not create " << out_path << std::endl;
+        return 1;
+    }
+    writeTable(out, traces, runs, rows);
+    return 0;
+}
@@ -0,0 +1,152 @@
+// File: process.h
+// Process control block shared by the lab 4 scheduler programs.
+
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <vector>
+#include <cstddef>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+// Every time in lab 4 (arrivals, bursts, deadlines, completions and the
+// durations derived from them) is an int in abstract time units. The
+// columns below stay 32 bits wide so the metric kernels can pack eight of
+// them into a vector. Code that computes a time in a wider type narrows it
+// with toTime(), which throws rather than wrapping once a run outgrows
+// that range.
+constexpr long long TIME_LIMIT = INT_MAX;
+
+inline int toTime(long long t) {
+    if (t < INT_MIN || t > TIME_LIMIT) {
+        throw std::overflow_error("time " + std::to_string(t) + " does not fit the int time range");
+    }
+    return static_cast<int>(t);
+}
+
+struct Process {
+    int pid;
+    int arrival_time;
+    int burst_time;
+    int remaining_time;
+    int completion_time = 0;
+    int turnaround_time = 0;
+    int waiting_time = 0;
+    int response_time = 0;   // first dispatch minus arrival
+    int priority;
+
+    // Real-time tasks (see realtime.h). A periodic task releases a job of
+    // burst_time (its WCET) every period, starting at arrival_time; each
+    // job is due deadline after its release (0 means at the next release).
+    // A sporadic task's period is only the minimum gap between releases.
+    int period = 0;          // 0: an ordinary one-shot process
+    int deadline = 0;
+    bool sporadic = false;
+
+    Process(int id, int at, int bt, int pr = 0)
+        : pid(id), arrival_time(at), burst_time(bt),
+          remaining_time(bt), priority(pr) {}
+
+    int relativeDeadline() const { return deadline > 0 ? deadline : period; }
+};
+
+// Struct-of-arrays form of a workload. Each field lives in its own contiguous
+// column, so a pass that needs only arrival times (or only bursts) streams
+// through just that column instead of striding over whole Process records.
+// The table is never modified by a scheduling run. Times are ints (see
+// TIME_LIMIT).
+struct ProcessTable {
+    std::vector<int> pid;
+    std::vector<int> arrival_time;
+    std::vector<int> burst_time;
+    std::vector<int> priority;
+    std::vector<int> deadline;   // absolute; INT_MAX for processes without one
+    std::vector<int> period;     // period of the job's real-time task, 0 otherwise
+
+    size_t size() const { return pid.size(); }
+    bool empty() const { return pid.empty(); }
+
+    void reserve(size_t n) {
+        pid.reserve(n);
+        arrival_time.reserve(n);
+        burst_time.reserve(n);
+        priority.reserve(n);
+        deadline.reserve(n);
+        period.reserve(n);
+    }
+
+    void add(int id, int at, int bt, int pr = 0) {
+        addJob(id, at, bt, pr, INT_MAX, 0);
+    }
+
+    // One job of a real-time task, due at absolute time due.
+    void addJob(int id, int release, int wcet, int pr, int due, int task_period) {
+        pid.push_back(id);
+        arrival_time.push_back(release);
+        burst_time.push_back(wcet);
+        priority.push_back(pr);
+        deadline.push_back(due);
+        period.push_back(task_period);
+    }
+
+    void clear() {
+        pid.clear();
+        arrival_time.clear();
+        burst_time.clear();
+        priority.clear();
+        deadline.clear();
+        period.clear();
+    }
+
+    static ProcessTable fromProcesses(const std::vector<Process>& procs) {
+        ProcessTable table;
+        table.reserve(procs.size());
+        for (const auto& p : procs) {
+            int due = p.relativeDeadline() > 0 ? p.arrival_time + p.relativeDeadline() : INT_MAX;
+            table.addJob(p.pid, p.arrival_time, p.burst_time, p.priority, due, p.period);
+        }
+        return table;
+    }
+};
+
+// Per-process output columns of one scheduling run, indexed like the
+// ProcessTable the run was given. A run fails rather than write a time past
+// TIME_LIMIT here.
+struct ScheduleResult {
+    std::vector<int> remaining_time;
+    std::vector<int> completion_time;
+    std::vector<int> turnaround_time;
+    std::vector<int> waiting_time;
+    std::vector<int> response_time;   // -1 until the process first runs
+
+    size_t size() const { return completion_time.size(); }
+
+    void reset(const ProcessTable& table) {
+        remaining_time = table.burst_time;
+        completion_time.assign(table.size(), 0);
+        turnaround_time.assign(table.size(), 0);
+        waiting_time.assign(table.size(), 0);
+        response_time.assign(table.size(), -1);
+    }
+};
+
+inline std::vector<Process> toProcesses(const ProcessTable& table, const ScheduleResult& result) {
+    std::vector<Process> procs;
+    procs.reserve(table.size());
+    for (size_t i = 0; i < table.size(); ++i) {
+        procs.emplace_back(table.pid[i], table.arrival_time[i], table.burst_time[i], table.priority[i]);
+        procs.back().period = table.period[i];
+        if (table.deadline[i] != INT_MAX) procs.back().deadline = table.deadline[i] - table.arrival_time[i];
+        if (i < result.size()) {
+            procs.back().remaining_time = result.remaining_time[i];
+            procs.back().completion_time = result.completion_time[i];
+            procs.back().turnaround_time = result.turnaround_time[i];
+            procs.back().waiting_time = result.waiting_time[i];
+            procs.back().response_time = result.response_time[i];
+        }
+    }
+    return procs;
+}
+
+#endif // PROCESS_H
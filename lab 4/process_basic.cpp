@@ -1,78 +1,83 @@
-// File: process_basics.cpp
-// Compile: g++ -o process_basics process_basics.cpp -std=c++17
+// File: process_basic.cpp
+// Compile: g++ -O2 -pthread -o process_basic process_basic.cpp -std=c++17
+// Usage:   ./process_basic            (textbook example under every policy)
+//          ./process_basic 10000000   (random workload of N processes, timed)
 
 #include <iostream>
 #include <vector>
-#include <queue>
-#include <algorithm>
-#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
 
-struct Process {
-    int pid;
-    int arrival_time;
-    int burst_time;
-    int remaining_time;
-    int completion_time;
-    int turnaround_time;
-    int waiting_time;
-    int priority;
-    
-    Process(int id, int at, int bt, int pr = 0) 
-        : pid(id), arrival_time(at), burst_time(bt), 
-          remaining_time(bt), priority(pr) {}
+#include "scheduler.h"
+
+const SchedulingPolicy ALL_POLICIES[] = {
+    SchedulingPolicy::FCFS, SchedulingPolicy::SJF, SchedulingPolicy::SRTF,
+    SchedulingPolicy::PRIORITY, SchedulingPolicy::PRIORITY_PREEMPTIVE,
+    SchedulingPolicy::ROUND_ROBIN, SchedulingPolicy::MLFQ, SchedulingPolicy::CFS
 };
 
-class ProcessScheduler {
-public:
-    std::vector<Process> processes;
-    
-    void addProcess(int pid, int arrival, int burst, int priority = 0) {
-        processes.emplace_back(pid, arrival, burst, priority);
-    }
-    
-    void displayProcesses() {
-        std::cout << std::setw(5) << "PID" << std::setw(10) << "Arrival" 
-                  << std::setw(10) << "Burst" << std::setw(12) << "Completion" 
-                  << std::setw(12) << "Turnaround" << std::setw(10) << "Waiting\n";
-        std::cout << std::string(60, '-') << "\n";
-        
-        for (const auto& p : processes) {
-            std::cout << std::setw(5) << p.pid << std::setw(10) << p.arrival_time
-                      << std::setw(10) << p.burst_time << std::setw(12) << p.completion_time
-                      << std::setw(12) << p.turnaround_time << std::setw(10) << p.waiting_time << "\n";
-        }
+void runExample() {
+    std::cout << "Basic Process Structure Demo\n";
+    std::cout << "============================\n";
+
+    for (SchedulingPolicy policy : ALL_POLICIES) {
+        ProcessScheduler scheduler;
+
+        // Example processes
+        scheduler.addProcess(1, 0, 7, 3);
+        scheduler.addProcess(2, 2, 4, 1);
+        scheduler.addProcess(3, 4, 1, 4);
+        scheduler.addProcess(4, 5, 4, 2);
+
+        scheduler.run(policy, 2);
+
+        std::cout << "\n--- " << policyName(policy) << " ---\n";
+        scheduler.displayProcesses();
+
+        MetricsCalculator calc;
+        scheduler.exportMetrics(calc);
+        calc.displayMetrics();
     }
-    
-    double calculateAverageWaitingTime() {
-        int total = 0;
-        for (const auto& p : processes) {
-            total += p.waiting_time;
-        }
-        return static_cast<double>(total) / processes.size();
+}
+
+void runBenchmark(int count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> gap(0, 40);
+    std::uniform_int_distribution<> burst(1, 200);
+    std::uniform_int_distribution<> prio(0, 31);
+
+    ProcessTable workload;
+    workload.reserve(count);
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(gen);
+        workload.add(i + 1, arrival, burst(gen), prio(gen));
     }
-    
-    double calculateAverageTurnaroundTime() {
-        int total = 0;
-        for (const auto& p : processes) {
-            total += p.turnaround_time;
-        }
-        return static_cast<double>(total) / processes.size();
+
+    std::cout << "Simulating " << count << " processes\n";
+    for (SchedulingPolicy policy : ALL_POLICIES) {
+        ProcessScheduler scheduler;
+        scheduler.table = workload;
+
+        auto start = std::chrono::steady_clock::now();
+        scheduler.run(policy, 100);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(24) << policyName(policy) << std::right
+                  << std::fixed << std::setprecision(3) << std::setw(8) << elapsed << " s"
+                  << "  events=" << scheduler.stats.events
+                  << "  switches=" << scheduler.stats.context_switches
+                  << std::setprecision(1)
+                  << "  avg wait=" << scheduler.calculateAverageWaitingTime() << "\n";
     }
-};
+}
 
-// Demo main function
-int main() {
-    ProcessScheduler scheduler;
-    
-    // Example processes
-    scheduler.addProcess(1, 0, 7);
-    scheduler.addProcess(2, 2, 4);
-    scheduler.addProcess(3, 4, 1);
-    scheduler.addProcess(4, 5, 4);
-    
-    std::cout << "Basic Process Structure Demo\n";
-    std::cout << "============================\n";
-    scheduler.displayProcesses();
-    
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        runBenchmark(std::atoi(argv[1]));
+    } else {
+        runExample();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+// File: real_exec.cpp
+// Compile: g++ -O2 -pthread -o real_exec real_exec.cpp -std=c++17
+// Usage:   ./real_exec                                 (textbook example, round robin)
+//          ./real_exec <processes> [policy] [quantum] [unit_ms] [cpu]
+//          policy: fcfs, sjf, srtf, priority, priority-preemptive, rr, mlfq, cfs, edf, rm (default rr)
+//
+// Runs the workload twice: once in the simulator and once as real
+// CPU-bound child processes pinned to one CPU and time-sliced by the same
+// ready queue (see real_executor.h), one time unit being unit_ms (default
+// 10) of wall-clock time. Prints simulated against measured turnaround per
+// process and for the whole run, along with the CPU time each child was
+// charged according to wait4.
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+
+#include "real_executor.h"
+
+int compareRun(const ProcessTable& workload, SchedulingPolicy policy, int quantum, const RealExecConfig& config) {
+    ProcessScheduler simulated;
+    simulated.table = workload;
+    simulated.run(policy, quantum);
+
+    ScheduleResult measured_result;
+    RealExecResult measured;
+    try {
+        measured = executePolicy(workload, measured_result, policy, quantum, config);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << policyName(policy);
+    if (policy == SchedulingPolicy::ROUND_ROBIN || policy == SchedulingPolicy::MLFQ) std::cout << " (quantum " << quantum << ")";
+    std::cout << ", " << workload.size() << " processes on CPU " << measured.cpu
+              << ", 1 unit = " << config.unit_ms << " ms\n\n";
+
+    std::cout << std::setw(6) << "PID" << std::setw(9) << "Arrival" << std::setw(7) << "Burst"
+              << std::setw(11) << "Sim turn" << std::setw(12) << "Real turn" << std::setw(13) << "CPU (ms)"
+              << std::setw(12) << "Burst (ms)" << "\n";
+    std::cout << std::string(70, '-') << "\n";
+    for (size_t i = 0; i < workload.size(); ++i) {
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(6) << workload.pid[i] << std::setw(9) << workload.arrival_time[i]
+                  << std::setw(7) << workload.burst_time[i]
+                  << std::setw(11) << simulated.result.turnaround_time[i]
+                  << std::setw(12) << measured.turnaround_ms[i] / config.unit_ms
+                  << std::setw(13) << measured.cpu_ms[i]
+                  << std::setw(12) << workload.burst_time[i] * config.unit_ms << "\n";
+    }
+
+    MetricsCalculator sim, real;
+    simulated.exportMetrics(sim);
+    real.setResult(measured_result);
+
+    double real_turnaround = 0, real_response = 0, real_makespan = 0;
+    for (size_t i = 0; i < workload.size(); ++i) {
+        real_turnaround += measured.turnaround_ms[i] / config.unit_ms;
+        real_response += measured.response_ms[i] / config.unit_ms;
+        real_makespan = std::max(real_makespan, measured.completion_ms[i] / config.unit_ms);
+    }
+    real_turnaround /= workload.size();
+    real_response /= workload.size();
+
+    std::cout << "\n" << std::setw(26) << "Simulated" << std::setw(12) << "Measured" << "\n";
+    std::cout << std::setprecision(2);
+    std::cout << std::left << std::setw(16) << "Avg turnaround" << std::right
+              << std::setw(10) << sim.getAverageTurnaroundTime() << std::setw(12) << real_turnaround << "\n";
+    std::cout << std::left << std::setw(16) << "Avg waiting" << std::right
+              << std::setw(10) << sim.getAverageWaitingTime() << std::setw(12) << real.getAverageWaitingTime() << "\n";
+    std::cout << std::left << std::setw(16) << "Avg response" << std::right
+              << std::setw(10) << sim.getAverageResponseTime() << std::setw(12) << real_response << "\n";
+    std::cout << std::left << std::setw(16) << "Makespan" << std::right
+              << std::setw(10) << simulated.stats.makespan << std::setw(12) << real_makespan << "\n";
+    std::cout << std::left << std::setw(16) << "Switches" << std::right
+              << std::setw(10) << simulated.stats.context_switches << std::setw(12) << measured.context_switches << "\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Children exec this program again as their CPU-bound worker.
+    if (argc == 3 && std::strcmp(argv[1], "--burn") == 0) {
+        return burnCpu(std::atol(argv[2]));
+    }
+
+    RealExecConfig config;
+    if (argc == 1) {
+        ProcessTable workload;
+        workload.add(1, 0, 7, 3);
+        workload.add(2, 2, 4, 1);
+        workload.add(3, 4, 1, 4);
+        workload.add(4, 5, 4, 2);
+        return compareRun(workload, SchedulingPolicy::ROUND_ROBIN, 2, config);
+    }
+
+    int count = std::atoi(argv[1]);
+    SchedulingPolicy policy = SchedulingPolicy::ROUND_ROBIN;
+    if (argc > 2 && !parsePolicy(argv[2], policy)) {
+        std::cerr << "Error: unknown policy " << argv[2] << std::endl;
+        return 1;
+    }
+    int quantum = argc > 3 ? std::atoi(argv[3]) : 4;
+    config.unit_ms = argc > 4 ? std::atoi(argv[4]) : 10;
+    config.cpu = argc > 5 ? std::atoi(argv[5]) : -1;
+    if (count <= 0 || count > 200 || config.unit_ms <= 0) {
+        std::cerr << "Error: need 1 to 200 processes and a positive unit" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> gap(0, 8);
+    std::uniform_int_distribution<> burst(1, 12);
+    std::uniform_int_distribution<> prio(0, 31);
+    ProcessTable workload;
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(gen);
+        workload.add(i + 1, arrival, burst(gen), prio(gen));
+    }
+    return compareRun(workload, policy, quantum, config);
+}
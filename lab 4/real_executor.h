@@ -0,0 +1,347 @@
+// File: real_executor.h
+// Runs a workload as real processes under the lab 4 ready queues.
+//
+// Each process becomes a child that execs a CPU-bound worker (burnCpu)
+// which spins until it has used burst * unit_ms of CPU time. The dispatcher
+// and all children are pinned to one CPU with sched_setaffinity, so at most
+// one child can make progress at a time, and the dispatcher drives them with
+// SIGCONT and SIGSTOP: the same ready queue the simulator uses picks who
+// runs next and for how long. Children are forked stopped before the clock
+// starts and only count as arrived at their arrival time.
+//
+// A child's completion is noticed through SIGCHLD and reaped with wait4, so
+// alongside the wall-clock turnaround we get the CPU time the kernel
+// actually charged it. Time units of the ready queues (quantum, vruntime,
+// remaining time) are unit_ms of wall-clock time.
+
+#ifndef REAL_EXECUTOR_H
+#define REAL_EXECUTOR_H
+
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+
+#include "scheduler.h"
+
+struct RealExecConfig {
+    int unit_ms = 10;       // wall-clock length of one time unit
+    int cpu = -1;           // CPU to run everything on; -1 = the first one we may use
+    std::string worker;     // program the children exec with "--burn <ms>"; default: this program
+};
+
+// Per-process measurements, indexed like the workload's rows.
+struct RealExecResult {
+    std::vector<double> completion_ms;
+    std::vector<double> turnaround_ms;
+    std::vector<double> response_ms;
+    std::vector<double> cpu_ms;        // user + system time from wait4
+    long long context_switches = 0;
+    long long preemptions = 0;
+    int cpu = -1;
+};
+
+// Body of a worker child: spins until the process has used ms of CPU time.
+inline int burnCpu(long ms) {
+    volatile unsigned long sink = 0;
+    struct timespec ts;
+    for (;;) {
+        for (int i = 0; i < 100000; ++i) sink = sink + static_cast<unsigned long>(i);
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        if (ts.tv_sec * 1000L + ts.tv_nsec / 1000000L >= ms) return 0;
+    }
+}
+
+template <typename ReadyQueue>
+class RealExecutor {
+private:
+    const ProcessTable& table;
+    ScheduleResult& result;   // in time units; the ready queue reads it too
+    ReadyQueue& ready;
+    bool preemptive;
+    int quantum;
+    RealExecConfig config;
+
+    RealExecResult out;
+    std::vector<pid_t> pids;
+    std::vector<double> used_ms;   // CPU time handed to each child so far
+    std::chrono::steady_clock::time_point start;
+    cpu_set_t original_affinity;
+
+    int running = -1;
+    int last_run = -1;
+    double dispatched_ms = 0;
+    double slice_end_ms = 0;
+    size_t finished = 0;
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    long long toUnits(double ms) const { return static_cast<long long>(ms / config.unit_ms); }
+
+    static double cpuMs(const struct rusage& ru) {
+        return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000.0
+             + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1000.0;
+    }
+
+    void pinToCpu() {
+        CPU_ZERO(&original_affinity);
+        if (sched_getaffinity(0, sizeof(original_affinity), &original_affinity) != 0) {
+            throw std::runtime_error("sched_getaffinity failed");
+        }
+        int cpu = config.cpu;
+        if (cpu < 0) {
+            for (cpu = 0; cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &original_affinity); ++cpu) {}
+        }
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        if (sched_setaffinity(0, sizeof(one), &one) != 0) {
+            throw std::runtime_error("cannot pin to CPU " + std::to_string(cpu));
+        }
+        out.cpu = cpu;
+    }
+
+    // Forks every child up front; each stops itself before exec, so none has
+    // run when the clock starts. They inherit the CPU pinning.
+    void spawnAll(const sigset_t& parent_mask) {
+        std::vector<std::string> bursts(table.size());
+        for (size_t i = 0; i < table.size(); ++i) {
+            bursts[i] = std::to_string(static_cast<long>(table.burst_time[i]) * config.unit_ms);
+        }
+        for (size_t i = 0; i < table.size(); ++i) {
+            pid_t pid = fork();
+            if (pid < 0) throw std::runtime_error("fork failed");
+            if (pid == 0) {
+                sigprocmask(SIG_SETMASK, &parent_mask, nullptr);
+                raise(SIGSTOP);
+                char* argv[] = {const_cast<char*>(config.worker.c_str()), const_cast<char*>("--burn"),
+                                const_cast<char*>(bursts[i].c_str()), nullptr};
+                execv(config.worker.c_str(), argv);
+                _exit(127);
+            }
+            pids[i] = pid;
+            int status;
+            if (wait4(pid, &status, WUNTRACED, nullptr) != pid || !WIFSTOPPED(status)) {
+                throw std::runtime_error("worker did not start");
+            }
+        }
+    }
+
+    void charge(int slot, double now) {
+        double before = used_ms[slot];
+        used_ms[slot] += now - dispatched_ms;
+        dispatched_ms = now;
+        long long ran = toUnits(used_ms[slot]) - toUnits(before);
+        ready.ran(slot, ran);
+        // A child may need a little longer than its burst; it stays at one
+        // unit left until it actually exits.
+        long long left = table.burst_time[slot] - toUnits(used_ms[slot]);
+        result.remaining_time[slot] = static_cast<int>(std::max(1LL, left));
+    }
+
+    void complete(int slot, double now, int status, const struct rusage& ru) {
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            throw std::runtime_error("worker for process " + std::to_string(table.pid[slot]) + " failed");
+        }
+        double arrival_ms = static_cast<double>(table.arrival_time[slot]) * config.unit_ms;
+        out.completion_ms[slot] = now;
+        out.turnaround_ms[slot] = now - arrival_ms;
+        out.cpu_ms[slot] = cpuMs(ru);
+        result.remaining_time[slot] = 0;
+        result.completion_time[slot] = toTime(std::lround(now / config.unit_ms));
+        result.turnaround_time[slot] = result.completion_time[slot] - table.arrival_time[slot];
+        result.waiting_time[slot] = std::max(0, result.turnaround_time[slot] - table.burst_time[slot]);
+        pids[slot] = -1;   // reaped
+        ++finished;
+        if (slot == running) running = -1;
+        last_run = -1;
+    }
+
+    // Reaps the running child if it has exited.
+    bool reapRunning(double now) {
+        struct rusage ru;
+        int status;
+        if (wait4(pids[running], &status, WNOHANG, &ru) != pids[running]) return false;
+        charge(running, now);
+        complete(running, now, status, ru);
+        return true;
+    }
+
+    // Stops the running child. It may exit before the stop takes effect.
+    void stopRunning(double now) {
+        struct rusage ru;
+        int status;
+        kill(pids[running], SIGSTOP);
+        if (wait4(pids[running], &status, WUNTRACED, &ru) != pids[running]) throw std::runtime_error("wait4 failed");
+        charge(running, now);
+        if (!WIFSTOPPED(status)) {
+            complete(running, now, status, ru);
+            return;
+        }
+        ready.push(running);
+        running = -1;
+        ++out.preemptions;
+    }
+
+    void dispatch(double now) {
+        running = ready.top();
+        ready.pop();
+        if (running != last_run) ++out.context_switches;
+        last_run = running;
+        if (result.response_time[running] < 0) {
+            double arrival_ms = static_cast<double>(table.arrival_time[running]) * config.unit_ms;
+            out.response_ms[running] = now - arrival_ms;
+            result.response_time[running] = toTime(std::lround(out.response_ms[running] / config.unit_ms));
+        }
+        long long slice = ready.sliceFor(running, quantum);
+        dispatched_ms = now;
+        slice_end_ms = slice > 0 ? now + static_cast<double>(slice) * config.unit_ms : HUGE_VAL;
+        kill(pids[running], SIGCONT);
+    }
+
+    void killAll() {
+        for (pid_t& pid : pids) {
+            if (pid <= 0) continue;
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            pid = -1;
+        }
+    }
+
+    void loop() {
+        std::vector<int> order(table.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return table.arrival_time[a] < table.arrival_time[b];
+        });
+        size_t next = 0;
+
+        sigset_t chld;
+        sigemptyset(&chld);
+        sigaddset(&chld, SIGCHLD);
+
+        start = std::chrono::steady_clock::now();
+        while (finished < table.size()) {
+            double now = elapsedMs();
+            ready.advance(toUnits(now));
+            while (next < order.size() && table.arrival_time[order[next]] * static_cast<double>(config.unit_ms) <= now) {
+                ready.arrived(order[next]);
+                ready.push(order[next]);
+                ++next;
+            }
+
+            if (running != -1 && !reapRunning(now)) {
+                if (now >= slice_end_ms) {
+                    stopRunning(now);
+                } else if (preemptive && !ready.empty()) {
+                    charge(running, now);
+                    if (ready.preempts(ready.top(), running)) stopRunning(now);
+                }
+            }
+            if (running == -1 && !ready.empty()) dispatch(now);
+
+            // Sleep until the slice ends, the next process arrives or a
+            // child exits, whichever is first.
+            double wake = running != -1 ? slice_end_ms : HUGE_VAL;
+            if (next < order.size()) wake = std::min(wake, table.arrival_time[order[next]] * static_cast<double>(config.unit_ms));
+            double wait_ms = std::min(std::max(0.0, wake - elapsedMs()), 1000.0);
+            struct timespec timeout;
+            timeout.tv_sec = static_cast<time_t>(wait_ms / 1000);
+            timeout.tv_nsec = static_cast<long>(std::fmod(wait_ms, 1000.0) * 1e6);
+            sigtimedwait(&chld, nullptr, &timeout);
+        }
+    }
+
+public:
+    RealExecutor(const ProcessTable& t, ScheduleResult& r, ReadyQueue& queue, bool is_preemptive, int time_quantum,
+                 const RealExecConfig& cfg)
+        : table(t), result(r), ready(queue), preemptive(is_preemptive), quantum(time_quantum), config(cfg) {
+        if (config.unit_ms <= 0) throw std::invalid_argument("unit_ms must be positive");
+        if (config.worker.empty()) config.worker = "/proc/self/exe";
+    }
+
+    // Fills the caller's result columns (in time units) as well.
+    RealExecResult run() {
+        size_t n = table.size();
+        out.completion_ms.assign(n, 0);
+        out.turnaround_ms.assign(n, 0);
+        out.response_ms.assign(n, 0);
+        out.cpu_ms.assign(n, 0);
+        pids.assign(n, -1);
+        used_ms.assign(n, 0);
+
+        // SIGCHLD stays blocked so that loop() can wait for it with
+        // sigtimedwait; the children get the original mask back.
+        pinToCpu();
+        sigset_t chld, parent_mask;
+        sigemptyset(&chld);
+        sigaddset(&chld, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &chld, &parent_mask);
+        try {
+            spawnAll(parent_mask);
+            loop();
+        } catch (...) {
+            killAll();
+            sched_setaffinity(0, sizeof(original_affinity), &original_affinity);
+            sigprocmask(SIG_SETMASK, &parent_mask, nullptr);
+            throw;
+        }
+        sched_setaffinity(0, sizeof(original_affinity), &original_affinity);
+        sigprocmask(SIG_SETMASK, &parent_mask, nullptr);
+        return out;
+    }
+};
+
+template <typename ReadyQueue, typename... QueueArgs>
+RealExecResult executeReal(const ProcessTable& table, ScheduleResult& result, const RealExecConfig& config,
+                           bool preemptive, int quantum, QueueArgs&&... args) {
+    result.reset(table);
+    ReadyQueue ready(table, result, std::forward<QueueArgs>(args)...);
+    return RealExecutor<ReadyQueue>(table, result, ready, preemptive, quantum, config).run();
+}
+
+// Real-process counterpart of simulatePolicy, on one CPU. result receives
+// the measured schedule in time units, ready for MetricsCalculator.
+inline RealExecResult executePolicy(const ProcessTable& table, ScheduleResult& result, SchedulingPolicy policy,
+                                    int quantum, const RealExecConfig& config,
+                                    const PolicyOptions& options = PolicyOptions()) {
+    switch (policy) {
+        case SchedulingPolicy::FCFS:
+            return executeReal<FifoReadyQueue>(table, result, config, false, 0);
+        case SchedulingPolicy::SJF:
+            return executeReal<KeyedReadyQueue<ByBurst>>(table, result, config, false, 0);
+        case SchedulingPolicy::SRTF:
+            return executeReal<KeyedReadyQueue<ByRemaining>>(table, result, config, true, 0);
+        case SchedulingPolicy::PRIORITY:
+            return executeReal<KeyedReadyQueue<ByPriority>>(table, result, config, false, 0);
+        case SchedulingPolicy::PRIORITY_PREEMPTIVE:
+            return executeReal<KeyedReadyQueue<ByPriority>>(table, result, config, true, 0);
+        case SchedulingPolicy::ROUND_ROBIN:
+            return executeReal<FifoReadyQueue>(table, result, config, false, quantum);
+        case SchedulingPolicy::MLFQ:
+            return executeReal<MlfqReadyQueue>(table, result, config, true, quantum, quantum, options.mlfq);
+        case SchedulingPolicy::CFS:
+            return executeReal<CfsReadyQueue>(table, result, config, true, 0, options.cfs);
+        case SchedulingPolicy::EDF:
+            return executeReal<KeyedReadyQueue<ByDeadline>>(table, result, config, true, 0);
+        case SchedulingPolicy::RATE_MONOTONIC:
+            return executeReal<KeyedReadyQueue<ByPeriod>>(table, result, config, true, 0);
+    }
+    return RealExecResult();
+}
+
+#endif // REAL_EXECUTOR_H
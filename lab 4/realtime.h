@@ -0,0 +1,227 @@
+// File: realtime.h
+// Periodic and sporadic real-time tasks for the lab 4 scheduler.
+//
+// A task is a Process with a period (see process.h): burst_time is its
+// worst-case execution time C, period its period (or minimum inter-release
+// time) T, relativeDeadline() its deadline D and arrival_time the release of
+// its first job. expandJobs turns a task set into the jobs the EDF and
+// rate-monotonic policies dispatch.
+//
+// The analyses decide schedulability on one CPU without simulating the
+// hyperperiod. Each tries the cheap utilization tests first and only falls
+// back to an exact test when they are inconclusive:
+//   Rate monotonic  Liu & Layland and hyperbolic bounds (D = T), then
+//                   response-time analysis in priority order.
+//   EDF             U <= 1 (D >= T), then quick processor-demand analysis
+//                   (QPA, Zhang & Burns), which checks a handful of points
+//                   instead of every deadline in the busy period.
+// Both are exact for synchronous tasks with D <= T, except that rate
+// monotonic treats tasks with equal periods as interfering with each other,
+// which may reject a set the simulator happens to schedule.
+
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+
+#include "process.h"
+
+// Jobs released before horizon. Sporadic tasks wait up to half a period
+// longer than the minimum between releases.
+inline ProcessTable expandJobs(const std::vector<Process>& tasks, int horizon, unsigned seed = 1) {
+    std::mt19937 gen(seed);
+    ProcessTable jobs;
+    for (const Process& task : tasks) {
+        if (task.period <= 0) continue;
+        std::uniform_int_distribution<> extra(0, task.sporadic ? task.period / 2 : 0);
+        for (long long release = task.arrival_time; release < horizon; release += task.period + extra(gen)) {
+            long long due = std::min<long long>(release + task.relativeDeadline(), INT_MAX - 1);
+            jobs.addJob(task.pid, toTime(release), task.burst_time, task.priority,
+                        static_cast<int>(due), task.period);
+        }
+    }
+    return jobs;
+}
+
+inline double totalUtilization(const std::vector<Process>& tasks) {
+    double u = 0;
+    for (const Process& task : tasks) u += static_cast<double>(task.burst_time) / task.period;
+    return u;
+}
+
+struct SchedulabilityResult {
+    bool schedulable = false;
+    std::string test;                      // the test that decided
+    double utilization = 0;
+    std::vector<long long> response_time;  // rate monotonic RTA: worst case per task, -1 if not computed
+};
+
+inline SchedulabilityResult analyzeRateMonotonic(const std::vector<Process>& tasks) {
+    SchedulabilityResult r;
+    size_t n = tasks.size();
+    r.utilization = totalUtilization(tasks);
+    if (n == 0) {
+        r.schedulable = true;
+        r.test = "empty";
+        return r;
+    }
+    if (r.utilization > 1.0) {
+        r.test = "utilization > 1";
+        return r;
+    }
+
+    bool implicit = std::all_of(tasks.begin(), tasks.end(), [](const Process& t) { return t.relativeDeadline() == t.period; });
+    if (implicit) {
+        if (r.utilization <= n * (std::pow(2.0, 1.0 / n) - 1)) {
+            r.schedulable = true;
+            r.test = "Liu & Layland bound";
+            return r;
+        }
+        double product = 1;
+        for (const Process& task : tasks) product *= 1.0 + static_cast<double>(task.burst_time) / task.period;
+        if (product <= 2.0) {
+            r.schedulable = true;
+            r.test = "hyperbolic bound";
+            return r;
+        }
+    }
+
+    // Response-time analysis: R = C_i + sum over higher priority j of
+    // ceil(R / T_j) * C_j, iterated to a fixed point. The fixed point is at
+    // least the total WCET of the task and everything above it, and at least
+    // C_i more than the response time of any task with a shorter period
+    // (Sjodin & Hansson); starting from the larger bound saves most of the
+    // iterations on big task sets.
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return tasks[a].period < tasks[b].period; });
+
+    // The inner loop runs O(n^2) times, so it reads periods and WCETs from
+    // contiguous arrays in priority order. Responses are checked against the
+    // deadline before each pass and so fit in 32 bits, which keeps the
+    // divisions cheap.
+    std::vector<uint32_t> period(n), wcet(n);
+    for (size_t pos = 0; pos < n; ++pos) {
+        period[pos] = static_cast<uint32_t>(tasks[order[pos]].period);
+        wcet[pos] = static_cast<uint32_t>(tasks[order[pos]].burst_time);
+    }
+
+    r.test = "response-time analysis";
+    r.response_time.assign(n, -1);
+    long long prefix_wcet = 0;
+    long long shorter_response = 0;   // worst response among shorter periods
+    long long group_response = 0;     // ... and among this period so far
+    size_t end = 0;
+    for (size_t pos = 0; pos < n; ++pos) {
+        if (pos > 0 && period[pos - 1] != period[pos]) {
+            shorter_response = std::max(shorter_response, group_response);
+        }
+        // Tasks sharing this period count as higher priority too.
+        long long group_wcet = 0;
+        if (end <= pos) {
+            end = pos + 1;
+            while (end < n && period[end] == period[pos]) ++end;
+        }
+        for (size_t j = pos + 1; j < end; ++j) group_wcet += wcet[j];
+
+        prefix_wcet += wcet[pos];
+        long long deadline = tasks[order[pos]].relativeDeadline();
+        long long response = std::max(prefix_wcet + group_wcet, shorter_response + wcet[pos]);
+        for (;;) {
+            if (response > deadline) return r;
+            uint32_t rounded = static_cast<uint32_t>(response - 1);
+            long long next = 0;
+            for (size_t j = 0; j < end; ++j) {
+                next += static_cast<long long>(rounded / period[j] + 1) * wcet[j];
+            }
+            // The loop counted this task's own job like an interfering one.
+            next -= static_cast<long long>(rounded / period[pos]) * wcet[pos];
+            if (next == response) break;
+            response = next;
+        }
+        r.response_time[order[pos]] = response;
+        group_response = std::max(group_response, response);
+    }
+    r.schedulable = true;
+    return r;
+}
+
+inline SchedulabilityResult analyzeEdf(const std::vector<Process>& tasks) {
+    SchedulabilityResult r;
+    r.utilization = totalUtilization(tasks);
+    if (r.utilization > 1.0) {
+        r.test = "utilization > 1";
+        return r;
+    }
+    if (std::all_of(tasks.begin(), tasks.end(), [](const Process& t) { return t.relativeDeadline() >= t.period; })) {
+        r.schedulable = true;
+        r.test = "utilization <= 1";
+        return r;
+    }
+
+    // Processor demand h(t): work with both release and deadline in [0, t].
+    auto demand = [&](long long t) {
+        long long h = 0;
+        for (const Process& task : tasks) {
+            long long d = task.relativeDeadline();
+            if (d <= t) h += ((t - d) / task.period + 1) * task.burst_time;
+        }
+        return h;
+    };
+    // Latest absolute deadline strictly before t.
+    auto deadlineBefore = [&](long long t) {
+        long long best = -1;
+        for (const Process& task : tasks) {
+            long long d = task.relativeDeadline();
+            if (d < t) best = std::max(best, (t - 1 - d) / task.period * task.period + d);
+        }
+        return best;
+    };
+
+    long long min_deadline = LLONG_MAX, max_deadline = 0;
+    for (const Process& task : tasks) {
+        min_deadline = std::min<long long>(min_deadline, task.relativeDeadline());
+        max_deadline = std::max<long long>(max_deadline, task.relativeDeadline());
+    }
+
+    // Demand can only exceed supply within the first synchronous busy
+    // period. La bounds it more cheaply for U < 1 but grows without limit as
+    // U approaches 1 (and rounding can leave an exact 1 just below it), so
+    // the smaller of the two is used.
+    long long limit = 0, next = 0;
+    for (const Process& task : tasks) next += task.burst_time;
+    while (next != limit) {
+        limit = next;
+        next = 0;
+        for (const Process& task : tasks) next += (limit + task.period - 1) / task.period * task.burst_time;
+    }
+    if (r.utilization < 1.0) {
+        double slack = 0;
+        for (const Process& task : tasks) {
+            slack += (task.period - task.relativeDeadline()) * static_cast<double>(task.burst_time) / task.period;
+        }
+        double la = std::max<double>(max_deadline, std::ceil(slack / (1.0 - r.utilization)));
+        if (la < limit) limit = static_cast<long long>(la);
+    }
+
+    // QPA: walk backwards from the last deadline before the limit, jumping
+    // straight to h(t) whenever it is below t.
+    r.test = "processor demand (QPA)";
+    long long t = deadlineBefore(limit + 1);
+    long long h = demand(t);
+    while (h <= t && h > min_deadline) {
+        t = h < t ? h : deadlineBefore(t);
+        h = demand(t);
+    }
+    r.schedulable = h <= min_deadline;
+    return r;
+}
+
+#endif // REALTIME_H
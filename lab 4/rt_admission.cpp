@@ -0,0 +1,142 @@
+// File: rt_admission.cpp
+// Compile: g++ -O2 -pthread -o rt_admission rt_admission.cpp -std=c++17
+// Usage:   ./rt_admission                         (two textbook task sets, analysed and simulated)
+//          ./rt_admission <tasks> [utilization] [sets]
+//
+// The second form draws random task sets (UUniFast utilizations, periods
+// log-uniform between 10^4 and 10^7, deadlines in the upper half between
+// WCET and period) and
+// times the rate-monotonic and EDF admission tests on them. The default is
+// 20 sets at each of 0.5, 0.7, 0.8, 0.9, 0.95 and 1.0.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <cstdlib>
+
+#include "scheduler.h"
+#include "realtime.h"
+
+Process makeTask(int pid, int wcet, int period, int deadline = 0) {
+    Process task(pid, 0, wcet);
+    task.period = period;
+    task.deadline = deadline;
+    return task;
+}
+
+void simulateTaskSet(const std::vector<Process>& tasks, SchedulingPolicy policy) {
+    int hyperperiod = 1;
+    for (const Process& task : tasks) hyperperiod = std::lcm(hyperperiod, task.period);
+
+    ProcessScheduler scheduler;
+    scheduler.table = expandJobs(tasks, hyperperiod);
+    scheduler.run(policy);
+
+    MetricsCalculator calc;
+    scheduler.exportMetrics(calc);
+    std::cout << std::left << std::setw(16) << policyName(policy) << std::right
+              << calc.getDeadlineMisses() << " of " << scheduler.table.size()
+              << " jobs missed over the hyperperiod (" << hyperperiod << " units)\n";
+}
+
+void showAnalysis(const char* name, const SchedulabilityResult& r) {
+    std::cout << std::left << std::setw(16) << name << std::right
+              << (r.schedulable ? "schedulable" : "not schedulable") << " (" << r.test << ")";
+    if (r.schedulable && !r.response_time.empty()) {
+        std::cout << ", worst-case response:";
+        for (long long rt : r.response_time) std::cout << " " << rt;
+    }
+    std::cout << "\n";
+}
+
+void runExample() {
+    const std::vector<std::vector<Process>> sets = {
+        {makeTask(1, 1, 4), makeTask(2, 2, 6), makeTask(3, 3, 12)},
+        {makeTask(1, 2, 5), makeTask(2, 4, 7)},
+    };
+
+    std::cout << "Real-Time Scheduling Demo\n";
+    std::cout << "=========================\n";
+    for (const auto& tasks : sets) {
+        std::cout << "\nTasks (C, T):";
+        for (const Process& task : tasks) std::cout << " (" << task.burst_time << ", " << task.period << ")";
+        std::cout << "  U = " << std::fixed << std::setprecision(3) << totalUtilization(tasks) << "\n";
+
+        showAnalysis("Rate Monotonic", analyzeRateMonotonic(tasks));
+        showAnalysis("EDF", analyzeEdf(tasks));
+        simulateTaskSet(tasks, SchedulingPolicy::RATE_MONOTONIC);
+        simulateTaskSet(tasks, SchedulingPolicy::EDF);
+    }
+}
+
+// UUniFast (Bini & Buttazzo): n utilizations summing to total, uniformly
+// distributed over the simplex.
+std::vector<Process> randomTaskSet(int count, double total, std::mt19937& gen) {
+    std::uniform_real_distribution<> unit(0.0, 1.0);
+    std::vector<Process> tasks;
+    tasks.reserve(count);
+    double remaining = total;
+    for (int i = 0; i < count; ++i) {
+        double u = remaining;
+        if (i + 1 < count) {
+            double next = remaining * std::pow(unit(gen), 1.0 / (count - i - 1));
+            u = remaining - next;
+            remaining = next;
+        }
+        int period = static_cast<int>(std::exp(std::log(1e4) + unit(gen) * std::log(1e3)));
+        int wcet = std::max(1, static_cast<int>(std::lround(u * period)));
+        std::uniform_int_distribution<> deadline((wcet + period) / 2, period);
+        tasks.push_back(makeTask(i + 1, wcet, period, deadline(gen)));
+    }
+    return tasks;
+}
+
+void runBenchmark(int count, const std::vector<double>& utilizations, int sets) {
+    std::mt19937 gen(42);
+    std::cout << "Admission tests on " << sets << " random sets of " << count << " tasks\n\n";
+    std::cout << std::setw(6) << "U" << std::setw(10) << "RM ok" << std::setw(12) << "RM time"
+              << std::setw(10) << "EDF ok" << std::setw(12) << "EDF time" << "\n";
+    std::cout << std::string(50, '-') << "\n";
+
+    for (double u : utilizations) {
+        int rm_ok = 0, edf_ok = 0;
+        double rm_time = 0, edf_time = 0;
+        for (int s = 0; s < sets; ++s) {
+            std::vector<Process> tasks = randomTaskSet(count, u, gen);
+
+            auto start = std::chrono::steady_clock::now();
+            rm_ok += analyzeRateMonotonic(tasks).schedulable;
+            rm_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            start = std::chrono::steady_clock::now();
+            edf_ok += analyzeEdf(tasks).schedulable;
+            edf_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(6) << u
+                  << std::setw(7) << rm_ok << "/" << std::left << std::setw(2) << sets << std::right
+                  << std::setprecision(3) << std::setw(9) << rm_time * 1e3 / sets << " ms"
+                  << std::setw(7) << edf_ok << "/" << std::left << std::setw(2) << sets << std::right
+                  << std::setw(9) << edf_time * 1e3 / sets << " ms\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        runExample();
+        return 0;
+    }
+
+    int count = std::atoi(argv[1]);
+    if (count <= 0) {
+        std::cerr << "Error: task count must be positive" << std::endl;
+        return 1;
+    }
+    std::vector<double> utilizations = {0.5, 0.7, 0.8, 0.9, 0.95, 1.0};
+    if (argc > 2) utilizations = {std::atof(argv[2])};
+    int sets = argc > 3 ? std::atoi(argv[3]) : 20;
+    runBenchmark(count, utilizations, std::max(1, sets));
+    return 0;
+}
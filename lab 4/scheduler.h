@@ -0,0 +1,1286 @@
+// File: scheduler.h
+// Discrete-event CPU scheduler used by the lab 4 programs.
+//
+// Rather than advancing a clock one time unit at a time, the engine keeps a
+// min-heap of pending events (arrivals and end-of-slice) and jumps from one
+// event to the next. The cost is O(n log n) in the number of processes and
+// does not depend on how long the bursts are.
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <deque>
+#include <numeric>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+#include "process.h"
+#include "metrics.h"
+#include "vruntime_tree.h"
+#include "timeline.h"
+
+enum class SchedulingPolicy {
+    FCFS,
+    SJF,
+    SRTF,
+    PRIORITY,
+    PRIORITY_PREEMPTIVE,
+    ROUND_ROBIN,
+    MLFQ,
+    CFS,
+    EDF,
+    RATE_MONOTONIC
+};
+
+inline const char* policyName(SchedulingPolicy policy) {
+    switch (policy) {
+        case SchedulingPolicy::FCFS: return "FCFS";
+        case SchedulingPolicy::SJF: return "SJF";
+        case SchedulingPolicy::SRTF: return "SRTF";
+        case SchedulingPolicy::PRIORITY: return "Priority";
+        case SchedulingPolicy::PRIORITY_PREEMPTIVE: return "Priority (preemptive)";
+        case SchedulingPolicy::ROUND_ROBIN: return "Round Robin";
+        case SchedulingPolicy::MLFQ: return "MLFQ";
+        case SchedulingPolicy::CFS: return "CFS";
+        case SchedulingPolicy::EDF: return "EDF";
+        case SchedulingPolicy::RATE_MONOTONIC: return "Rate Monotonic";
+    }
+    return "?";
+}
+
+// Accepts the short names used on the command line: fcfs, sjf, srtf,
+// priority, priority-preemptive, rr, mlfq, cfs, edf and rm.
+inline bool parsePolicy(const std::string& name, SchedulingPolicy& policy) {
+    static const struct { const char* name; SchedulingPolicy policy; } names[] = {
+        {"fcfs", SchedulingPolicy::FCFS},
+        {"sjf", SchedulingPolicy::SJF},
+        {"srtf", SchedulingPolicy::SRTF},
+        {"priority", SchedulingPolicy::PRIORITY},
+        {"priority-preemptive", SchedulingPolicy::PRIORITY_PREEMPTIVE},
+        {"rr", SchedulingPolicy::ROUND_ROBIN},
+        {"mlfq", SchedulingPolicy::MLFQ},
+        {"cfs", SchedulingPolicy::CFS},
+        {"edf", SchedulingPolicy::EDF},
+        {"rm", SchedulingPolicy::RATE_MONOTONIC},
+    };
+    for (const auto& entry : names) {
+        if (name == entry.name) {
+            policy = entry.policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+struct SimulationStats {
+    long long makespan = 0;
+    long long busy_time = 0;
+    long long idle_time = 0;
+    long long context_switches = 0;
+    long long preemptions = 0;
+    long long events = 0;
+    long long migrations = 0;                   // tasks moved onto this CPU by load balancing
+    long long deadline_jobs = 0;                // completed processes that had a deadline
+    long long deadline_misses = 0;              // ... and completed after it
+    long long max_lateness = 0;
+    long long switch_overhead = 0;              // CPU time lost to context switches and cache refills
+    std::vector<ColumnSummary> level_latency;   // MLFQ: ready-to-dispatch wait per level
+    std::vector<long long> cpu_busy_time;       // multicore runs: one entry per CPU
+    std::vector<long long> cpu_migrations;
+};
+
+//=============================================================================
+// READY QUEUES
+//=============================================================================
+
+// Hooks the engine calls on every ready queue. Queues that keep per-process
+// state (MLFQ) override them; the rest inherit these no-ops.
+class BasicReadyQueue {
+public:
+    // The engine may stretch a slice past the quantum while nobody else is
+    // ready (see EventEngine::dispatch).
+    static constexpr bool EXTENDABLE = true;
+
+    void advance(long long) {}                               // clock moved to now
+    void arrived(int) {}                                     // slot holds a newly arrived process
+    long long sliceFor(int, int quantum) const { return quantum; }   // 0 = run to completion
+    void ran(int, long long) {}                              // slot used the CPU for a while
+    void report(SimulationStats&) const {}
+
+    // Per-slot state that follows a queued process to another CPU's queue
+    // (see MulticoreSimulation). detach is called after the slot is popped.
+    struct SlotState {};
+    SlotState detach(int) { return SlotState(); }
+    void attach(int, const SlotState&) {}
+};
+
+// FCFS and round robin: processes run in the order they became ready.
+class FifoReadyQueue : public BasicReadyQueue {
+private:
+    std::deque<int> queue;
+
+public:
+    FifoReadyQueue(const ProcessTable&, const ScheduleResult&) {}
+
+    void push(int index) { queue.push_back(index); }
+    int top() const { return queue.front(); }
+    void pop() { queue.pop_front(); }
+    bool empty() const { return queue.empty(); }
+    bool preempts(int, int) const { return false; }
+};
+
+struct ByBurst {
+    long long operator()(const ProcessTable& t, const ScheduleResult&, int i) const { return t.burst_time[i]; }
+};
+
+struct ByRemaining {
+    long long operator()(const ProcessTable&, const ScheduleResult& r, int i) const { return r.remaining_time[i]; }
+};
+
+struct ByPriority {
+    long long operator()(const ProcessTable& t, const ScheduleResult&, int i) const { return t.priority[i]; }
+};
+
+// Earliest deadline first.
+struct ByDeadline {
+    long long operator()(const ProcessTable& t, const ScheduleResult&, int i) const { return t.deadline[i]; }
+};
+
+// Rate monotonic: the task with the shortest period has the highest priority.
+struct ByPeriod {
+    long long operator()(const ProcessTable& t, const ScheduleResult&, int i) const { return t.period[i]; }
+};
+
+// SJF, SRTF, priority, EDF and rate monotonic: smallest key first, ties
+// broken by the order in which processes became ready.
+template <typename KeyFn>
+class KeyedReadyQueue : public BasicReadyQueue {
+private:
+    struct Entry {
+        long long key;
+        long long seq;
+        int index;
+    };
+
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.key != b.key ? a.key > b.key : a.seq > b.seq;
+        }
+    };
+
+    const ProcessTable& table;
+    const ScheduleResult& result;
+    std::priority_queue<Entry, std::vector<Entry>, Later> heap;
+    long long next_seq = 0;
+
+    long long keyOf(int index) const { return KeyFn()(table, result, index); }
+
+public:
+    KeyedReadyQueue(const ProcessTable& t, const ScheduleResult& r) : table(t), result(r) {}
+
+    void push(int index) { heap.push({keyOf(index), next_seq++, index}); }
+    int top() const { return heap.top().index; }
+    void pop() { heap.pop(); }
+    bool empty() const { return heap.empty(); }
+
+    bool preempts(int candidate, int running) const {
+        return keyOf(candidate) < keyOf(running);
+    }
+};
+
+struct MlfqConfig {
+    int levels = 8;                  // at most MlfqReadyQueue::MAX_LEVELS
+    long long boost_interval = 1000; // 0 disables the periodic priority boost
+};
+
+// Multilevel feedback queue in the style of the Linux O(1) scheduler: one
+// FIFO run queue per level plus a bitmap of non-empty levels, so picking the
+// next process is a single find-first-set however many processes are queued.
+//
+// New processes start at level 0. Level L has an allotment of
+// quantum << L; once a process has used its allotment (across however many
+// slices) it drops a level. The bottom level runs to completion. Every
+// boost_interval all processes go back to level 0 so long jobs cannot
+// starve. Run queues are intrusive lists threaded through per-slot arrays,
+// which makes the boost a splice of at most MAX_LEVELS lists.
+class MlfqReadyQueue : public BasicReadyQueue {
+public:
+    static constexpr int MAX_LEVELS = 64;
+    static constexpr bool EXTENDABLE = false;
+
+private:
+    int levels;
+    int base_quantum;
+    long long boost_interval;
+    long long next_boost;
+    long long now = 0;
+    unsigned epoch = 0;              // bumped by every boost
+
+    uint64_t nonempty = 0;           // bit L set <=> level L has a queued process
+    int head[MAX_LEVELS];
+    int tail[MAX_LEVELS];
+
+    // Per-slot state. A slot whose epoch is stale was boosted: its real
+    // level is 0 and its allotment is fresh.
+    std::vector<int> level;
+    std::vector<long long> used;
+    std::vector<unsigned> slot_epoch;
+    std::vector<int> next;
+    std::vector<long long> enqueued_at;
+
+    std::vector<ColumnSummary> latency;
+
+    void track(int slot) {
+        if (slot >= static_cast<int>(level.size())) {
+            size_t n = static_cast<size_t>(slot) + 1;
+            level.resize(n, 0);
+            used.resize(n, 0);
+            slot_epoch.resize(n, epoch);
+            next.resize(n, -1);
+            enqueued_at.resize(n, 0);
+        }
+        if (slot_epoch[slot] != epoch) {
+            slot_epoch[slot] = epoch;
+            level[slot] = 0;
+            used[slot] = 0;
+        }
+    }
+
+    long long allotment(int lvl) const {
+        return static_cast<long long>(base_quantum) << std::min(lvl, 30);
+    }
+
+    void boost() {
+        int first = -1, last = -1;
+        for (uint64_t bits = nonempty; bits; bits &= bits - 1) {
+            int lvl = __builtin_ctzll(bits);
+            if (first == -1) first = head[lvl];
+            else next[last] = head[lvl];
+            last = tail[lvl];
+            head[lvl] = tail[lvl] = -1;
+        }
+        head[0] = first;
+        tail[0] = last;
+        nonempty = first == -1 ? 0 : 1;
+        ++epoch;
+    }
+
+public:
+    MlfqReadyQueue(const ProcessTable&, const ScheduleResult&, int quantum, const MlfqConfig& config)
+        : levels(std::max(1, std::min(config.levels, MAX_LEVELS))),
+          base_quantum(std::max(1, quantum)),
+          boost_interval(config.boost_interval),
+          next_boost(config.boost_interval),
+          latency(levels) {
+        std::fill(head, head + MAX_LEVELS, -1);
+        std::fill(tail, tail + MAX_LEVELS, -1);
+    }
+
+    void advance(long long time) {
+        now = time;
+        if (boost_interval > 0 && now >= next_boost) {
+            boost();
+            next_boost = (now / boost_interval + 1) * boost_interval;
+        }
+    }
+
+    void arrived(int slot) {
+        track(slot);
+        level[slot] = 0;
+        used[slot] = 0;
+    }
+
+    void push(int slot) {
+        track(slot);
+        int& lvl = level[slot];
+        if (lvl < levels - 1 && used[slot] >= allotment(lvl)) {
+            ++lvl;
+            used[slot] = 0;
+        }
+        next[slot] = -1;
+        if (tail[lvl] == -1) head[lvl] = slot;
+        else next[tail[lvl]] = slot;
+        tail[lvl] = slot;
+        nonempty |= uint64_t(1) << lvl;
+        enqueued_at[slot] = now;
+    }
+
+    int top() const { return head[__builtin_ctzll(nonempty)]; }
+
+    void pop() {
+        int lvl = __builtin_ctzll(nonempty);
+        int slot = head[lvl];
+        head[lvl] = next[slot];
+        if (head[lvl] == -1) {
+            tail[lvl] = -1;
+            nonempty &= ~(uint64_t(1) << lvl);
+        }
+        latency[lvl].add(static_cast<int>(std::min<long long>(now - enqueued_at[slot], INT_MAX)));
+    }
+
+    bool empty() const { return nonempty == 0; }
+
+    // Only a process queued at a higher level than the running one preempts it.
+    bool preempts(int, int running) {
+        track(running);
+        return __builtin_ctzll(nonempty) < level[running];
+    }
+
+    long long sliceFor(int slot, int) {
+        track(slot);
+        if (level[slot] == levels - 1) return 0;
+        return allotment(level[slot]) - used[slot];
+    }
+
+    void ran(int slot, long long amount) {
+        track(slot);
+        used[slot] += amount;
+    }
+
+    void report(SimulationStats& stats) const { stats.level_latency = latency; }
+
+    // A migrated process keeps its level and the allotment it has used.
+    struct SlotState {
+        int level;
+        long long used;
+    };
+
+    SlotState detach(int slot) {
+        track(slot);
+        return {level[slot], used[slot]};
+    }
+
+    void attach(int slot, const SlotState& state) {
+        track(slot);
+        level[slot] = std::min(state.level, levels - 1);
+        used[slot] = state.used;
+    }
+};
+
+struct CfsConfig {
+    long long target_latency = 24;   // every runnable task should run once per period
+    long long min_granularity = 3;   // shortest slice; also the wakeup preemption threshold
+};
+
+// Completely Fair Scheduler in the style of Linux CFS. Each task carries a
+// weight derived from its priority and a virtual runtime that advances by
+// ran * NICE_0_WEIGHT / weight, so heavier tasks age more slowly. Runnable
+// tasks sit in a red-black tree keyed by vruntime and the leftmost one runs
+// next, for a slice of the scheduling period proportional to its weight.
+//
+// Priority is read as a nice value: lower means more important, and values
+// outside [-20, 19] are clamped.
+class CfsReadyQueue : public BasicReadyQueue {
+public:
+    static constexpr long long NICE_0_WEIGHT = 1024;
+
+private:
+    // Vruntime carries 10 extra bits so small slices of heavy tasks still
+    // advance it.
+    static constexpr int VRUNTIME_SHIFT = 10;
+
+    const ProcessTable& table;
+    CfsConfig config;
+    VruntimeTree tree;
+    std::vector<long long> vruntime;
+    long long min_vruntime = 0;
+    long long queued_weight = 0;
+
+    long long weightOf(int slot) const {
+        // Linux sched_prio_to_weight: each nice step is roughly 10% of CPU.
+        static const int weights[40] = {
+            88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916,
+            9548, 7620, 6100, 4904, 3906, 3121, 2501, 1991, 1586, 1277,
+            1024, 820, 655, 526, 423, 335, 272, 215, 172, 137,
+            110, 87, 70, 56, 45, 36, 29, 23, 18, 15,
+        };
+        int nice = std::max(-20, std::min(19, table.priority[slot]));
+        return weights[nice + 20];
+    }
+
+    long long scaled(long long time, int slot) const {
+        return (time << VRUNTIME_SHIFT) * NICE_0_WEIGHT / weightOf(slot);
+    }
+
+    void track(int slot) {
+        if (slot >= static_cast<int>(vruntime.size())) vruntime.resize(static_cast<size_t>(slot) + 1, 0);
+    }
+
+public:
+    CfsReadyQueue(const ProcessTable& t, const ScheduleResult&, const CfsConfig& cfg)
+        : table(t), config(cfg) {}
+
+    // New tasks start level with the most-behind runnable task instead of
+    // at zero, which would let them monopolise the CPU.
+    void arrived(int slot) {
+        track(slot);
+        vruntime[slot] = min_vruntime;
+    }
+
+    void push(int slot) {
+        track(slot);
+        tree.insert(vruntime[slot], slot);
+        queued_weight += weightOf(slot);
+    }
+
+    int top() const { return tree.value(tree.first()); }
+
+    void pop() {
+        int node = tree.first();
+        queued_weight -= weightOf(tree.value(node));
+        tree.erase(node);
+    }
+
+    bool empty() const { return tree.empty(); }
+
+    // Wakeup preemption: the newcomer must be behind the running task by
+    // more than the granularity, measured in the newcomer's vruntime units.
+    bool preempts(int candidate, int running) const {
+        return vruntime[running] - vruntime[candidate] > scaled(config.min_granularity, candidate);
+    }
+
+    long long sliceFor(int slot, int) const {
+        long long runnable = static_cast<long long>(tree.size()) + 1;
+        long long period = std::max(config.target_latency, runnable * config.min_granularity);
+        long long weight = weightOf(slot);
+        return std::max(1LL, period * weight / (queued_weight + weight));
+    }
+
+    void ran(int slot, long long amount) {
+        vruntime[slot] += scaled(amount, slot);
+        long long current = vruntime[slot];
+        if (!tree.empty()) current = std::min(current, tree.key(tree.first()));
+        min_vruntime = std::max(min_vruntime, current);
+    }
+
+    // Vruntimes on different CPUs are unrelated, so a migrating task carries
+    // its lag behind the source queue's min_vruntime, as Linux does.
+    struct SlotState {
+        long long lag;
+    };
+
+    SlotState detach(int slot) { return {vruntime[slot] - min_vruntime}; }
+
+    void attach(int slot, const SlotState& state) {
+        track(slot);
+        vruntime[slot] = min_vruntime + state.lag;
+    }
+};
+
+//=============================================================================
+// WORKLOADS
+//=============================================================================
+
+// A workload hands the engine processes in arrival order. Each process lives
+// in a row ("slot") of the table/result columns the workload exposes; the
+// engine reads and writes only through those slots and tells the workload
+// when a slot's process has completed.
+
+// The whole workload is an in-memory ProcessTable; slot i is row i and the
+// results stay in the caller's ScheduleResult.
+class TableWorkload {
+private:
+    const ProcessTable& rows;
+    ScheduleResult& results;
+    std::vector<int> arrival_order;
+    size_t next_arrival = 0;
+
+public:
+    TableWorkload(const ProcessTable& t, ScheduleResult& r) : rows(t), results(r) {
+        results.reset(rows);
+
+        arrival_order.resize(rows.size());
+        std::iota(arrival_order.begin(), arrival_order.end(), 0);
+        // Traces are usually already in arrival order; only sort when needed.
+        if (!std::is_sorted(rows.arrival_time.begin(), rows.arrival_time.end())) {
+            std::stable_sort(arrival_order.begin(), arrival_order.end(), [this](int a, int b) {
+                return rows.arrival_time[a] < rows.arrival_time[b];
+            });
+        }
+    }
+
+    const ProcessTable& table() const { return rows; }
+    ScheduleResult& result() { return results; }
+
+    bool nextArrival(int& slot) {
+        if (next_arrival == arrival_order.size()) return false;
+        slot = arrival_order[next_arrival++];
+        return true;
+    }
+
+    void complete(int) {}
+};
+
+//=============================================================================
+// SWITCH COSTS
+//=============================================================================
+
+// What a CPU loses when it switches to a different process: a fixed
+// overhead for the switch itself plus a stall while the newcomer refills the
+// cache. A process that left this CPU only a moment ago still finds much of
+// its working set there; the refill grows linearly with the time it was away
+// until, after cache_lifetime, the cache is cold. A process that has never
+// run on this CPU (including one just migrated here) always starts cold,
+// which is what keeping processes on their CPU saves.
+//
+// Override switchCost for a different model. The default-constructed model
+// costs nothing, which is also what the engine assumes without one.
+struct SwitchCostModel {
+    long long switch_cost = 0;      // every switch to a different process
+    long long cache_refill = 0;     // extra stall with a completely cold cache
+    long long cache_lifetime = 0;   // time away after which the cache is cold
+
+    virtual ~SwitchCostModel() = default;
+
+    // away: time since the process last ran on this CPU, or -1 if it never has.
+    virtual long long switchCost(long long away) const {
+        long long refill = cache_refill;
+        if (away >= 0 && away < cache_lifetime) refill = cache_refill * away / cache_lifetime;
+        return switch_cost + refill;
+    }
+};
+
+//=============================================================================
+// EVENT ENGINE
+//=============================================================================
+
+template <typename ReadyQueue, typename Workload>
+class EventEngine {
+private:
+    enum EventType { ARRIVAL = 0, MIGRATION = 1, SLICE_END = 2 };
+
+    struct Event {
+        long long time;
+        int type;
+        int index;
+        unsigned generation;
+    };
+
+    // Arrivals (and migrations) sort before slice ends at the same instant,
+    // so a process whose quantum expires queues up behind anything that just
+    // arrived.
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time != b.time ? a.time > b.time : a.type > b.type;
+        }
+    };
+
+    Workload& workload;
+    const ProcessTable& table;
+    ScheduleResult& result;
+    ReadyQueue& ready;
+    bool preemptive;
+    int quantum;
+
+    std::priority_queue<Event, std::vector<Event>, Later> events;
+
+    int running = -1;
+    int last_run = -1;
+    unsigned generation = 0;   // bumped on every dispatch; stale SLICE_ENDs are ignored
+    long long run_start = 0;   // time the running process was last charged up to
+    long long dispatched_at = 0;
+    long long slice_origin = 0;   // end of the switch overhead; the process's own run starts here
+    long long slice_end = 0;
+    long long slice_limit = 0;
+    bool extended = false;     // round robin slice stretched because nobody else was ready
+    long long work = 0;        // remaining time of everything arrived or migrated here, charged up to run_start
+
+    SimulationStats stats;
+    TimelineRing* timeline = nullptr;
+    uint16_t cpu = 0;
+
+    // Who last left this CPU from each slot, and when, for cache warmth.
+    struct CacheState {
+        int pid = -1;
+        long long left_at = 0;
+    };
+    const SwitchCostModel* costs = nullptr;
+    std::vector<CacheState> cache;
+
+    void scheduleNextArrival() {
+        int slot;
+        if (workload.nextArrival(slot)) {
+            events.push({table.arrival_time[slot], ARRIVAL, slot, 0});
+        }
+    }
+
+    void charge(long long now) {
+        if (now <= run_start) return;   // still paying for the switch
+        long long ran = now - run_start;
+        ready.ran(running, ran);
+        result.remaining_time[running] -= static_cast<int>(ran);
+        work -= ran;
+        stats.busy_time += ran;
+        run_start = now;
+    }
+
+    // The running process leaves the CPU. It may be preempted before its
+    // switch overhead is even over, so only the part it paid counts.
+    void leave(long long now, uint8_t kind) {
+        long long work_start = std::min(now, slice_origin);
+        stats.switch_overhead += work_start - dispatched_at;
+        if (costs) {
+            if (cache.size() <= static_cast<size_t>(running)) cache.resize(running + 1);
+            cache[running] = {table.pid[running], now};
+        }
+        if (!timeline) return;
+        if (work_start > dispatched_at) {
+            timeline->record(static_cast<int32_t>(dispatched_at), static_cast<int32_t>(work_start - dispatched_at),
+                             table.pid[running], cpu, TIMELINE_SWITCH);
+        }
+        if (now > slice_origin) {
+            timeline->record(static_cast<int32_t>(slice_origin), static_cast<int32_t>(now - slice_origin),
+                             table.pid[running], cpu, kind);
+        }
+    }
+
+    long long switchCost(long long now) const {
+        if (!costs || running == last_run) return 0;
+        long long away = -1;
+        if (static_cast<size_t>(running) < cache.size() && cache[running].pid == table.pid[running]) {
+            away = now - cache[running].left_at;
+        }
+        return costs->switchCost(away);
+    }
+
+    void complete(long long now) {
+        result.completion_time[running] = toTime(now);
+        result.turnaround_time[running] = result.completion_time[running] - table.arrival_time[running];
+        result.waiting_time[running] = result.turnaround_time[running] - table.burst_time[running];
+        stats.makespan = std::max(stats.makespan, now);
+        if (table.deadline[running] != INT_MAX) {
+            ++stats.deadline_jobs;
+            if (now > table.deadline[running]) {
+                ++stats.deadline_misses;
+                stats.max_lateness = std::max(stats.max_lateness, now - table.deadline[running]);
+            }
+        }
+        last_run = -1;   // the slot may be handed to a new process
+        workload.complete(running);
+    }
+
+    void dispatch(long long now) {
+        running = ready.top();
+        ready.pop();
+        long long overhead = switchCost(now);
+        if (running != last_run) ++stats.context_switches;
+        last_run = running;
+
+        if (result.response_time[running] < 0) {
+            result.response_time[running] = toTime(now) - table.arrival_time[running];
+        }
+
+        // The switch overhead comes on top of the slice, so the quantum
+        // still buys the same amount of useful work.
+        dispatched_at = now;
+        now += overhead;
+        run_start = slice_origin = now;
+        long long slice = result.remaining_time[running];
+        long long limit = slice_limit = ready.sliceFor(running, quantum);
+        extended = false;
+        if (limit > 0 && slice > limit) {
+            // With an empty ready queue, expiring every quantum only to pick
+            // the same process again is wasted work, so let it run until
+            // something arrives and cut the slice back to a quantum boundary.
+            if (ReadyQueue::EXTENDABLE && ready.empty()) extended = true;
+            else slice = limit;
+        }
+        slice_end = now + slice;
+        events.push({slice_end, SLICE_END, running, ++generation});
+    }
+
+    // Called right after charge(now), so run_start is the current time.
+    void truncateExtendedSlice() {
+        long long elapsed = run_start - slice_origin;
+        long long quanta = std::max(1LL, (elapsed + slice_limit - 1) / slice_limit);
+        long long boundary = slice_origin + quanta * slice_limit;
+        extended = false;
+        if (boundary < slice_end) {
+            slice_end = boundary;
+            events.push({slice_end, SLICE_END, running, ++generation});
+        }
+    }
+
+    void handle(const Event& ev, long long now) {
+        if (ev.type == ARRIVAL) {
+            work += result.remaining_time[ev.index];
+            ready.arrived(ev.index);
+            ready.push(ev.index);
+            scheduleNextArrival();
+            return;
+        }
+        if (ev.type == MIGRATION) {
+            ready.push(ev.index);
+            return;
+        }
+        if (ev.index != running || ev.generation != generation) return;
+
+        charge(now);
+        if (result.remaining_time[running] == 0) {
+            leave(now, TIMELINE_COMPLETED);
+            complete(now);
+        } else {
+            leave(now, TIMELINE_EXPIRED);
+            ready.push(running);
+            ++stats.preemptions;
+        }
+        running = -1;
+    }
+
+public:
+    EventEngine(Workload& w, ReadyQueue& queue, bool is_preemptive, int time_quantum = 0)
+        : workload(w), table(w.table()), result(w.result()), ready(queue),
+          preemptive(is_preemptive), quantum(time_quantum) {}
+
+    // Queues a process that some other party pulled from the workload; it
+    // arrives at its arrival time.
+    void inject(int slot) {
+        events.push({table.arrival_time[slot], ARRIVAL, slot, 0});
+    }
+
+    // Queues a process migrated from another CPU at time now; it becomes
+    // runnable here after cost. The caller has already attached its state
+    // to this engine's ready queue.
+    void migrateIn(int slot, long long now, long long cost) {
+        work += result.remaining_time[slot];
+        events.push({now + cost, MIGRATION, slot, 0});
+        ++stats.migrations;
+        if (timeline) {
+            timeline->record(static_cast<int32_t>(now), static_cast<int32_t>(cost), table.pid[slot], cpu,
+                             TIMELINE_MIGRATION);
+        }
+    }
+
+    // A queued process was taken off this CPU's ready queue for another.
+    void migrateOut(int slot) { work -= result.remaining_time[slot]; }
+
+    // Run intervals go to ring, tagged with this CPU's number.
+    void setTimeline(TimelineRing* ring, int cpu_id) {
+        timeline = ring;
+        cpu = static_cast<uint16_t>(cpu_id);
+    }
+
+    // Charges switches under model (not owned); without one they are free.
+    void setCostModel(const SwitchCostModel* model) { costs = model; }
+
+    bool hasEvents() const { return !events.empty(); }
+    long long nextEventTime() const { return events.top().time; }
+
+    // The earliest time after now (an instant all events before it have
+    // been handled at) this CPU could run out of work, if nothing new is
+    // queued here. It has work to do for at least the remaining time of
+    // everything it holds, and a running process keeps it busy until its
+    // slice ends. With nothing held, the next arrival is the earliest it
+    // gets anything; LLONG_MAX when nothing is coming either.
+    long long busyUntilAtLeast(long long now) const {
+        long long left = work;
+        if (running != -1) left -= std::max(0LL, now - run_start);
+        if (left > 0) return std::max(now + left, running != -1 ? slice_end : now);
+        if (running != -1) return slice_end;
+        return events.empty() ? LLONG_MAX : events.top().time;
+    }
+    int runningSlot() const { return running; }
+
+    // After runUntil(TIME_LIMIT + 1): whether work is left that could only
+    // finish past TIME_LIMIT. With nothing running, any slice end still
+    // queued is stale and is dropped.
+    bool outOfTime() {
+        if (running != -1 || !ready.empty()) return true;
+        for (; !events.empty(); events.pop()) {
+            if (events.top().type != SLICE_END) return true;
+        }
+        return false;
+    }
+
+    // Times are ints (see TIME_LIMIT), so the clock stops there: a workload
+    // that would run longer fails instead of wrapping its results.
+    SimulationStats run() {
+        scheduleNextArrival();
+        runUntil(TIME_LIMIT + 1);
+        if (outOfTime()) throw std::overflow_error("simulation ran past the int time range");
+        return finish();
+    }
+
+    // Handles every event before end. Anything still running keeps its
+    // pending slice end, so the run can be resumed with a later end.
+    void runUntil(long long end) {
+        while (!events.empty() && events.top().time < end) {
+            long long now = events.top().time;
+            ready.advance(now);
+            // Bring the running process up to date first, so queues that
+            // place newcomers relative to it (CFS) see its current state.
+            if (running != -1) charge(now);
+            do {
+                Event ev = events.top();
+                events.pop();
+                ++stats.events;
+                handle(ev, now);
+            } while (!events.empty() && events.top().time == now);
+
+            if (running != -1 && !ready.empty()) {
+                charge(now);
+                if (extended) {
+                    truncateExtendedSlice();
+                } else if (preemptive && ready.preempts(ready.top(), running)) {
+                    leave(now, TIMELINE_PREEMPTED);
+                    ready.push(running);
+                    running = -1;
+                    ++stats.preemptions;
+                }
+            }
+
+            if (running == -1 && !ready.empty()) {
+                dispatch(now);
+            }
+        }
+    }
+
+    SimulationStats finish() {
+        stats.idle_time = stats.makespan - stats.busy_time - stats.switch_overhead;
+        ready.report(stats);
+        return stats;
+    }
+};
+
+//=============================================================================
+// MULTICORE
+//=============================================================================
+
+struct MulticoreConfig {
+    int cpus = 1;
+    int threads = 0;                   // host threads for the per-CPU loops; 0 = one per host core
+    long long balance_interval = 256;  // time between full load balancing passes
+    long long migration_cost = 5;      // a migrated process waits this long before its new CPU can run it
+};
+
+// One CPU's view of a shared workload. Its engine pulls no arrivals itself
+// (MulticoreSimulation places them) and its completions are held back, so
+// the real workload is only ever touched from one thread between windows.
+template <typename Workload>
+class CoreWorkload {
+private:
+    const ProcessTable& rows;
+    ScheduleResult& results;
+
+public:
+    std::vector<int> completed;
+
+    explicit CoreWorkload(Workload& w) : rows(w.table()), results(w.result()) {}
+
+    const ProcessTable& table() const { return rows; }
+    ScheduleResult& result() { return results; }
+    bool nextArrival(int&) { return false; }
+    void complete(int slot) { completed.push_back(slot); }
+};
+
+// Reusable barrier for the host threads. The round counter lets a thread
+// tell the wakeup for its round from threads already arriving at the next.
+class WindowBarrier {
+private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    int parties;
+    int waiting = 0;
+    unsigned long long round = 0;
+
+public:
+    explicit WindowBarrier(int n) : parties(n) {}
+
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        unsigned long long my_round = round;
+        if (++waiting == parties) {
+            waiting = 0;
+            ++round;
+            cv.notify_all();
+            return;
+        }
+        cv.wait(lock, [&] { return round != my_round; });
+    }
+};
+
+// N simulated CPUs, each with its own ready queue and event engine.
+//
+// Time is cut into windows. Within a window the CPUs do not interact, so
+// their event loops run in parallel on host threads. At each window
+// boundary a single thread hands completions back to the workload. Every
+// balance_interval it also places the next interval's arrivals on the least
+// loaded CPUs and balances load: queued processes move from the busiest CPU
+// to the idlest until loads differ by at most one. A moved process becomes
+// runnable on its new CPU migration_cost later. Because all interaction
+// happens at the boundaries, results do not depend on the number of host
+// threads.
+//
+// A CPU that runs dry should not wait for the next balancing pass while
+// another CPU has work queued. So while any CPU has a backlog, a window also
+// ends just after the earliest moment some other CPU could run dry (see
+// windowEnd). At such an early boundary each idle CPU pulls one queued
+// process from the busiest CPU. Otherwise the CPUs are left alone.
+template <typename ReadyQueue, typename Workload>
+class MulticoreSimulation {
+private:
+    struct Cpu {
+        CoreWorkload<Workload> view;
+        ReadyQueue ready;
+        EventEngine<ReadyQueue, CoreWorkload<Workload>> engine;
+        long long load = 0;   // processes placed here and not yet completed
+
+        template <typename... QueueArgs>
+        Cpu(Workload& w, bool preemptive, int quantum, const QueueArgs&... args)
+            : view(w), ready(w.table(), w.result(), args...), engine(view, ready, preemptive, quantum) {}
+    };
+
+    Workload& workload;
+    MulticoreConfig config;
+    std::vector<std::unique_ptr<Cpu>> cpus;
+    int pending = -1;   // next arrival, pulled from the workload but not yet placed
+
+    void reapCompletions() {
+        for (auto& cpu : cpus) {
+            for (int slot : cpu->view.completed) workload.complete(slot);
+            cpu->load -= static_cast<long long>(cpu->view.completed.size());
+            cpu->view.completed.clear();
+        }
+    }
+
+    Cpu& leastLoaded() {
+        Cpu* best = cpus[0].get();
+        for (auto& cpu : cpus) {
+            if (cpu->load < best->load) best = cpu.get();
+        }
+        return *best;
+    }
+
+    void placeArrivals(long long end) {
+        while (pending != -1 && workload.table().arrival_time[pending] < end) {
+            Cpu& cpu = leastLoaded();
+            cpu.engine.inject(pending);
+            ++cpu.load;
+            if (!workload.nextArrival(pending)) pending = -1;
+        }
+    }
+
+    // The most loaded CPU with queued work, or null if nobody has any.
+    Cpu* busiestQueued() {
+        Cpu* busiest = nullptr;
+        for (auto& cpu : cpus) {
+            if (!cpu->ready.empty() && (!busiest || cpu->load > busiest->load)) busiest = cpu.get();
+        }
+        return busiest;
+    }
+
+    // Only queued processes move; a running process stays where it is.
+    void migrate(Cpu& from, Cpu& to, long long now) {
+        int slot = from.ready.top();
+        from.ready.pop();
+        from.engine.migrateOut(slot);
+        to.ready.attach(slot, from.ready.detach(slot));
+        to.engine.migrateIn(slot, now, config.migration_cost);
+        --from.load;
+        ++to.load;
+    }
+
+    void balance(long long now) {
+        for (;;) {
+            Cpu* busiest = busiestQueued();
+            Cpu& idlest = leastLoaded();
+            if (!busiest || busiest->load - idlest.load < 2) return;
+            migrate(*busiest, idlest, now);
+        }
+    }
+
+    // A CPU is idle if nothing runs or waits on it and nothing lands sooner
+    // than a pulled process would.
+    void pullToIdle(long long now) {
+        for (auto& cpu : cpus) {
+            if (cpu->engine.runningSlot() != -1 || !cpu->ready.empty()) continue;
+            if (cpu->engine.busyUntilAtLeast(now) <= now + config.migration_cost) continue;
+            Cpu* busiest = busiestQueued();
+            if (!busiest) return;
+            migrate(*busiest, *cpu, now);
+        }
+    }
+
+    // The window ends at the next balancing pass, or earlier if a CPU could
+    // run dry while another has a backlog (more than one process placed on
+    // it). If a CPU is idle already, the window ends after the next event
+    // on a backlogged CPU instead, since only that can give it something to
+    // pull. The +1 is because runUntil(end) handles the events before end.
+    long long windowEnd(long long now, long long next_balance) const {
+        bool backlog = false;
+        for (const auto& cpu : cpus) {
+            if (cpu->load >= 2) backlog = true;
+        }
+        if (!backlog) return next_balance;
+
+        long long end = next_balance;
+        bool idle = false;
+        for (const auto& cpu : cpus) {
+            long long busy_until = cpu->engine.busyUntilAtLeast(now);
+            if (busy_until == LLONG_MAX) idle = true;
+            else end = std::min(end, busy_until + 1);
+        }
+        if (idle) {
+            for (const auto& cpu : cpus) {
+                if (cpu->load >= 2 && cpu->engine.hasEvents()) end = std::min(end, cpu->engine.nextEventTime() + 1);
+            }
+        }
+        return std::max(end, now + 1);
+    }
+
+    bool anyEvents() const {
+        for (const auto& cpu : cpus) {
+            if (cpu->engine.hasEvents()) return true;
+        }
+        return false;
+    }
+
+    void simulateWindows(int threads, WindowBarrier& start, WindowBarrier& done,
+                         long long& window_end, bool& finished) {
+        long long interval = std::max(1LL, config.balance_interval);
+        long long now = 0, next_balance = 0;
+        if (!workload.nextArrival(pending)) pending = -1;
+
+        for (;;) {
+            reapCompletions();
+            // Times are ints (see TIME_LIMIT): windows stop there, and any
+            // work left over fails the run instead of wrapping its results.
+            if (now > TIME_LIMIT) {
+                bool left = pending != -1;
+                for (auto& cpu : cpus) left = cpu->engine.outOfTime() || left;
+                if (left) throw std::overflow_error("simulation ran past the int time range");
+            }
+            // With nothing left on any CPU, skip ahead to the next arrival.
+            if (!anyEvents()) {
+                if (pending == -1) break;
+                now = std::max<long long>(now, workload.table().arrival_time[pending]);
+                next_balance = now;
+            }
+            if (now >= next_balance) {
+                next_balance = now + interval;
+                placeArrivals(next_balance);
+                balance(now);
+            } else {
+                pullToIdle(now);
+            }
+            window_end = std::min(windowEnd(now, next_balance), TIME_LIMIT + 1);
+
+            start.arriveAndWait();
+            runCpus(0, threads, window_end);
+            done.arriveAndWait();
+            now = window_end;
+        }
+        finished = true;
+        start.arriveAndWait();
+    }
+
+    void runCpus(int thread, int threads, long long end) {
+        for (size_t i = static_cast<size_t>(thread); i < cpus.size(); i += static_cast<size_t>(threads)) {
+            cpus[i]->engine.runUntil(end);
+        }
+    }
+
+public:
+    template <typename... QueueArgs>
+    MulticoreSimulation(Workload& w, const MulticoreConfig& cfg, Timeline* timeline, const SwitchCostModel* costs,
+                        bool preemptive, int quantum, const QueueArgs&... args)
+        : workload(w), config(cfg) {
+        for (int i = 0; i < std::max(1, config.cpus); ++i) {
+            cpus.emplace_back(new Cpu(workload, preemptive, quantum, args...));
+            if (timeline) cpus.back()->engine.setTimeline(&timeline->ring(i), i);
+            cpus.back()->engine.setCostModel(costs);
+        }
+    }
+
+    SimulationStats run() {
+        int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+        threads = std::max(1, std::min(threads, static_cast<int>(cpus.size())));
+
+        WindowBarrier start(threads), done(threads);
+        long long window_end = 0;
+        bool finished = false;
+
+        std::vector<std::thread> workers;
+        for (int t = 1; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (;;) {
+                    start.arriveAndWait();
+                    if (finished) return;
+                    runCpus(t, threads, window_end);
+                    done.arriveAndWait();
+                }
+            });
+        }
+
+        try {
+            simulateWindows(threads, start, done, window_end, finished);
+        } catch (...) {
+            // Only the boundary work (the workload) can throw, and it runs
+            // while the workers wait at the start barrier.
+            finished = true;
+            start.arriveAndWait();
+            for (auto& worker : workers) worker.join();
+            throw;
+        }
+        for (auto& worker : workers) worker.join();
+
+        SimulationStats total;
+        std::vector<SimulationStats> per_cpu;
+        for (auto& cpu : cpus) {
+            per_cpu.push_back(cpu->engine.finish());
+            total.makespan = std::max(total.makespan, per_cpu.back().makespan);
+        }
+        for (const SimulationStats& s : per_cpu) {
+            total.busy_time += s.busy_time;
+            total.switch_overhead += s.switch_overhead;
+            total.context_switches += s.context_switches;
+            total.preemptions += s.preemptions;
+            total.events += s.events;
+            total.migrations += s.migrations;
+            total.deadline_jobs += s.deadline_jobs;
+            total.deadline_misses += s.deadline_misses;
+            total.max_lateness = std::max(total.max_lateness, s.max_lateness);
+            total.cpu_busy_time.push_back(s.busy_time);
+            total.cpu_migrations.push_back(s.migrations);
+            if (total.level_latency.size() < s.level_latency.size()) total.level_latency.resize(s.level_latency.size());
+            for (size_t lvl = 0; lvl < s.level_latency.size(); ++lvl) total.level_latency[lvl].merge(s.level_latency[lvl]);
+        }
+        total.idle_time = total.makespan * static_cast<long long>(cpus.size()) - total.busy_time - total.switch_overhead;
+        return total;
+    }
+};
+
+// Tuning beyond the quantum: knobs for the richer policies, the CPU count,
+// what switching costs and where to record the timeline.
+struct PolicyOptions {
+    MlfqConfig mlfq;
+    CfsConfig cfs;
+    MulticoreConfig multicore;
+    const SwitchCostModel* costs = nullptr;   // not owned; null makes switches free
+    Timeline* timeline = nullptr;             // not owned; null records nothing
+};
+
+// Runs a workload on one CPU, or on options.multicore.cpus of them.
+template <typename ReadyQueue, typename Workload, typename... QueueArgs>
+SimulationStats simulate(Workload& workload, const PolicyOptions& options, bool preemptive, int quantum,
+                         QueueArgs&&... args) {
+    if (options.multicore.cpus > 1) {
+        return MulticoreSimulation<ReadyQueue, Workload>(workload, options.multicore, options.timeline, options.costs,
+                                                         preemptive, quantum, args...).run();
+    }
+    ReadyQueue ready(workload.table(), workload.result(), std::forward<QueueArgs>(args)...);
+    EventEngine<ReadyQueue, Workload> engine(workload, ready, preemptive, quantum);
+    if (options.timeline) engine.setTimeline(&options.timeline->ring(0), 0);
+    engine.setCostModel(options.costs);
+    return engine.run();
+}
+
+// Runs a workload to completion under the given policy.
+template <typename Workload>
+SimulationStats simulatePolicy(Workload& workload, SchedulingPolicy policy, int quantum,
+                               const PolicyOptions& options = PolicyOptions()) {
+    switch (policy) {
+        case SchedulingPolicy::FCFS:
+            return simulate<FifoReadyQueue>(workload, options, false, 0);
+        case SchedulingPolicy::SJF:
+            return simulate<KeyedReadyQueue<ByBurst>>(workload, options, false, 0);
+        case SchedulingPolicy::SRTF:
+            return simulate<KeyedReadyQueue<ByRemaining>>(workload, options, true, 0);
+        case SchedulingPolicy::PRIORITY:
+            return simulate<KeyedReadyQueue<ByPriority>>(workload, options, false, 0);
+        case SchedulingPolicy::PRIORITY_PREEMPTIVE:
+            return simulate<KeyedReadyQueue<ByPriority>>(workload, options, true, 0);
+        case SchedulingPolicy::ROUND_ROBIN:
+            return simulate<FifoReadyQueue>(workload, options, false, quantum);
+        case SchedulingPolicy::MLFQ:
+            return simulate<MlfqReadyQueue>(workload, options, true, quantum, quantum, options.mlfq);
+        case SchedulingPolicy::CFS:
+            return simulate<CfsReadyQueue>(workload, options, true, 0, options.cfs);
+        case SchedulingPolicy::EDF:
+            return simulate<KeyedReadyQueue<ByDeadline>>(workload, options, true, 0);
+        case SchedulingPolicy::RATE_MONOTONIC:
+            return simulate<KeyedReadyQueue<ByPeriod>>(workload, options, true, 0);
+    }
+    return SimulationStats();
+}
+
+//=============================================================================
+// PROCESS SCHEDULER
+//=============================================================================
+
+class ProcessScheduler {
+public:
+    ProcessTable table;
+    ScheduleResult result;
+    SimulationStats stats;
+    PolicyOptions options;
+
+    void addProcess(int pid, int arrival, int burst, int priority = 0) {
+        table.add(pid, arrival, burst, priority);
+    }
+
+    // Runs the whole workload under the given policy and fills in the
+    // remaining/completion/turnaround/waiting column of every process.
+    // Set options.multicore.cpus to simulate more than one CPU.
+    void run(SchedulingPolicy policy, int quantum = 4) {
+        TableWorkload workload(table, result);
+        stats = simulatePolicy(workload, policy, quantum, options);
+    }
+
+    std::vector<Process> getProcesses() const {
+        return toProcesses(table, result);
+    }
+
+    void exportMetrics(MetricsCalculator& calc) const {
+        calc.setResult(result);
+        calc.setCPUIdleTime(stats.idle_time);
+        calc.setSwitchOverhead(stats.switch_overhead);
+        calc.setLevelLatency(stats.level_latency);
+        calc.setCoreUsage(stats.cpu_busy_time, stats.cpu_migrations);
+        calc.setDeadlineStats(stats.deadline_jobs, stats.deadline_misses, stats.max_lateness);
+    }
+
+    void displayProcesses() {
+        std::cout << std::setw(5) << "PID" << std::setw(10) << "Arrival"
+                  << std::setw(10) << "Burst" << std::setw(12) << "Completion"
+                  << std::setw(12) << "Turnaround" << std::setw(10) << "Waiting"
+                  << std::setw(10) << "Response\n";
+        std::cout << std::string(70, '-') << "\n";
+
+        for (const auto& p : getProcesses()) {
+            std::cout << std::setw(5) << p.pid << std::setw(10) << p.arrival_time
+                      << std::setw(10) << p.burst_time << std::setw(12) << p.completion_time
+                      << std::setw(12) << p.turnaround_time << std::setw(10) << p.waiting_time
+                      << std::setw(10) << p.response_time << "\n";
+        }
+    }
+
+    double calculateAverageWaitingTime() {
+        long long total = 0;
+        for (int w : result.waiting_time) {
+            total += w;
+        }
+        return static_cast<double>(total) / result.size();
+    }
+
+    double calculateAverageTurnaroundTime() {
+        long long total = 0;
+        for (int t : result.turnaround_time) {
+            total += t;
+        }
+        return static_cast<double>(total) / result.size();
+    }
+};
+
+#endif // SCHEDULER_H
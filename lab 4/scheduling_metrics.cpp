@@ -1,93 +1,63 @@
 // File: scheduling_metrics.cpp
-// Compile: g++ -o scheduling_metrics scheduling_metrics.cpp -std=c++17
+// Compile: g++ -O2 -o scheduling_metrics scheduling_metrics.cpp -std=c++17
+// Usage:   ./scheduling_metrics            (demo)
+//          ./scheduling_metrics 50000000   (time each metrics kernel on N rows)
 
-#include <iostream>
-#include <vector>
-#include <algorithm>
-#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
 
-struct Process {
-    int pid;
-    int arrival_time;
-    int burst_time;
-    int remaining_time;
-    int completion_time;
-    int turnaround_time;
-    int waiting_time;
-    int priority;
-    
-    Process(int id, int at, int bt, int pr = 0) 
-        : pid(id), arrival_time(at), burst_time(bt), 
-          remaining_time(bt), priority(pr) {}
-};
-
-class MetricsCalculator {
-private:
-    std::vector<Process> processes;
-    int total_time;
-    int cpu_idle_time;
+#include "process.h"
+#include "metrics.h"
 
-public:
-    void setProcesses(const std::vector<Process>& procs) {
-        processes = procs;
-        calculateTotalTime();
-    }
-    
-    void calculateTotalTime() {
-        if (processes.empty()) return;
-        
-        int max_completion = 0;
-        for (const auto& p : processes) {
-            max_completion = std::max(max_completion, p.completion_time);
-        }
-        total_time = max_completion;
+void benchmarkKernels(size_t rows) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<> dist(0, 2000000000);
+    ScheduleResult result;
+    result.completion_time.resize(rows);
+    result.turnaround_time.resize(rows);
+    result.waiting_time.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        result.completion_time[i] = dist(gen);
+        result.turnaround_time[i] = dist(gen);
+        result.waiting_time[i] = dist(gen);
     }
-    
-    double getCPUUtilization() {
-        int cpu_busy_time = total_time - cpu_idle_time;
-        return (static_cast<double>(cpu_busy_time) / total_time) * 100.0;
-    }
-    
-    double getThroughput() {
-        return static_cast<double>(processes.size()) / total_time;
-    }
-    
-    double getAverageWaitingTime() {
-        int total_waiting = 0;
-        for (const auto& p : processes) {
-            total_waiting += p.waiting_time;
+    const int* columns[3] = {result.completion_time.data(), result.turnaround_time.data(),
+                             result.waiting_time.data()};
+
+    std::cout << "Summarizing 3 columns x " << rows << " rows (best kernel: "
+              << metricsKernelName(bestMetricsKernel()) << ")\n";
+    ColumnSummary reference[3];
+    for (MetricsKernel kernel : {MetricsKernel::SCALAR, MetricsKernel::SSE41, MetricsKernel::AVX2}) {
+        if (kernel > bestMetricsKernel()) break;
+        ColumnSummary out[3];
+        double elapsed = 1e9;
+        for (int rep = 0; rep < 5; ++rep) {
+            std::fill(out, out + 3, ColumnSummary());
+            auto start = std::chrono::steady_clock::now();
+            summarizeColumns<3>(columns, rows, out, kernel);
+            elapsed = std::min(elapsed, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
         }
-        return static_cast<double>(total_waiting) / processes.size();
-    }
-    
-    double getAverageTurnaroundTime() {
-        int total_turnaround = 0;
-        for (const auto& p : processes) {
-            total_turnaround += p.turnaround_time;
+        if (kernel == MetricsKernel::SCALAR) std::copy(out, out + 3, reference);
+
+        bool same = true;
+        for (int k = 0; k < 3; ++k) {
+            same = same && out[k].sum == reference[k].sum && out[k].min == reference[k].min
+                   && out[k].max == reference[k].max
+                   && std::equal(out[k].histogram, out[k].histogram + HISTOGRAM_BUCKETS, reference[k].histogram);
         }
-        return static_cast<double>(total_turnaround) / processes.size();
-    }
-    
-    double getAverageResponseTime() {
-        // Assuming response time equals waiting time for simplicity
-        return getAverageWaitingTime();
+        std::cout << std::setw(8) << metricsKernelName(kernel) << ": " << std::fixed << std::setprecision(3)
+                  << elapsed * 1000 << " ms (best of 5), " << (same ? "matches scalar" : "MISMATCH") << "\n";
     }
-    
-    void displayMetrics() {
-        std::cout << std::fixed << std::setprecision(2);
-        std::cout << "\n=== SCHEDULING METRICS ===\n";
-        std::cout << "CPU Utilization: " << getCPUUtilization() << "%\n";
-        std::cout << "Throughput: " << getThroughput() << " processes/unit time\n";
-        std::cout << "Average Waiting Time: " << getAverageWaitingTime() << " units\n";
-        std::cout << "Average Turnaround Time: " << getAverageTurnaroundTime() << " units\n";
-        std::cout << "Average Response Time: " << getAverageResponseTime() << " units\n";
-    }
-    
-    void setCPUIdleTime(int idle) { cpu_idle_time = idle; }
-};
+}
 
 // Demo usage
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        benchmarkKernels(std::strtoull(argv[1], nullptr, 10));
+        return 0;
+    }
+
     std::vector<Process> sample_processes = {
         Process(1, 0, 7), Process(2, 2, 4), Process(3, 4, 1)
     };
@@ -96,14 +66,17 @@ int main() {
     sample_processes[0].completion_time = 7;
     sample_processes[0].turnaround_time = 7;
     sample_processes[0].waiting_time = 0;
+    sample_processes[0].response_time = 0;
     
     sample_processes[1].completion_time = 11;
     sample_processes[1].turnaround_time = 9;
     sample_processes[1].waiting_time = 5;
+    sample_processes[1].response_time = 5;
     
     sample_processes[2].completion_time = 12;
     sample_processes[2].turnaround_time = 8;
     sample_processes[2].waiting_time = 7;
+    sample_processes[2].response_time = 7;
     
     MetricsCalculator calc;
     calc.setProcesses(sample_processes);
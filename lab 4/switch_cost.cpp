@@ -0,0 +1,133 @@
+// File: switch_cost.cpp
+// Compile: g++ -O2 -pthread -o switch_cost switch_cost.cpp -std=c++17
+// Usage:   ./switch_cost                              (textbook example with and without switch costs)
+//          ./switch_cost <processes> [switch] [refill] [lifetime]
+//
+// The second form runs a random workload under round robin with quanta from
+// 1 to 64, first with free switches and then under a SwitchCostModel
+// (default: switch 1, refill 4, cache lifetime 50), and then on 4 CPUs with
+// balancing intervals from 16 to 1024 to show what migrations cost once a
+// moved process has to start with a cold cache.
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "scheduler.h"
+
+void runExample() {
+    SwitchCostModel costs;
+    costs.switch_cost = 1;
+    costs.cache_refill = 2;
+    costs.cache_lifetime = 8;
+    const SwitchCostModel* models[] = {nullptr, &costs};
+
+    for (const SwitchCostModel* model : models) {
+        ProcessScheduler scheduler;
+        scheduler.addProcess(1, 0, 7, 3);
+        scheduler.addProcess(2, 2, 4, 1);
+        scheduler.addProcess(3, 4, 1, 4);
+        scheduler.addProcess(4, 5, 4, 2);
+
+        scheduler.options.costs = model;
+        scheduler.run(SchedulingPolicy::ROUND_ROBIN, 2);
+
+        std::cout << (model ? "\nRound Robin (quantum 2), switch 1, refill 2, cache lifetime 8\n"
+                            : "Round Robin (quantum 2), free switches\n");
+        scheduler.displayProcesses();
+
+        MetricsCalculator calc;
+        scheduler.exportMetrics(calc);
+        calc.displayMetrics();
+    }
+}
+
+struct RunSummary {
+    long long makespan;
+    double overhead;
+    double turnaround;
+    long long p99_response;
+    long long migrations;
+};
+
+RunSummary runOnce(const ProcessTable& workload, SchedulingPolicy policy, int quantum, const PolicyOptions& options) {
+    ProcessScheduler scheduler;
+    scheduler.table = workload;
+    scheduler.options = options;
+    scheduler.run(policy, quantum);
+
+    MetricsCalculator calc;
+    scheduler.exportMetrics(calc);
+    return {scheduler.stats.makespan, calc.getSwitchOverhead(), calc.getAverageTurnaroundTime(),
+            calc.getResponseSummary().percentileUpperBound(99), scheduler.stats.migrations};
+}
+
+void runBenchmark(int count, const SwitchCostModel& costs) {
+    // About 65% load: free switches leave plenty of headroom, but small
+    // quanta under the cost model do not.
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> gap(0, 40);
+    std::uniform_int_distribution<> burst(1, 25);
+    std::uniform_int_distribution<> prio(0, 31);
+
+    ProcessTable workload;
+    workload.reserve(count);
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(gen);
+        workload.add(i + 1, arrival, burst(gen), prio(gen));
+    }
+
+    std::cout << "Round robin, " << count << " processes: switch " << costs.switch_cost
+              << ", refill " << costs.cache_refill << ", cache lifetime " << costs.cache_lifetime << "\n\n";
+    std::cout << std::setw(8) << "quantum" << std::setw(14) << "free: turn" << std::setw(10) << "p99 resp"
+              << std::setw(14) << "costed: turn" << std::setw(10) << "p99 resp" << std::setw(11) << "overhead"
+              << std::setw(12) << "makespan" << "\n";
+    std::cout << std::string(79, '-') << "\n";
+
+    PolicyOptions free_options, costed_options;
+    costed_options.costs = &costs;
+    for (int quantum : {1, 2, 4, 8, 16, 32, 64}) {
+        RunSummary free_run = runOnce(workload, SchedulingPolicy::ROUND_ROBIN, quantum, free_options);
+        RunSummary costed = runOnce(workload, SchedulingPolicy::ROUND_ROBIN, quantum, costed_options);
+        std::cout << std::fixed << std::setprecision(1) << std::setw(8) << quantum
+                  << std::setw(14) << free_run.turnaround << std::setw(10) << free_run.p99_response
+                  << std::setw(14) << costed.turnaround << std::setw(10) << costed.p99_response
+                  << std::setw(10) << costed.overhead << "%" << std::setw(12) << costed.makespan << "\n";
+    }
+
+    // Four CPUs' worth of the same arrivals: balancing more often evens out
+    // the queues but moves more processes away from their warm caches.
+    ProcessTable busy = workload;
+    for (int& at : busy.arrival_time) at /= 4;
+
+    std::cout << "\nRound robin (quantum 16) on 4 CPUs, same costs, 4x the arrival rate\n\n";
+    std::cout << std::setw(10) << "interval" << std::setw(12) << "migrations" << std::setw(11) << "overhead"
+              << std::setw(12) << "avg turn" << std::setw(10) << "p99 resp" << "\n";
+    std::cout << std::string(55, '-') << "\n";
+    for (long long interval : {16, 64, 256, 1024}) {
+        PolicyOptions options = costed_options;
+        options.multicore.cpus = 4;
+        options.multicore.balance_interval = interval;
+        RunSummary r = runOnce(busy, SchedulingPolicy::ROUND_ROBIN, 16, options);
+        std::cout << std::setw(10) << interval << std::setw(12) << r.migrations
+                  << std::setw(10) << r.overhead << "%" << std::setw(12) << r.turnaround
+                  << std::setw(10) << r.p99_response << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        runExample();
+        return 0;
+    }
+
+    SwitchCostModel costs;
+    costs.switch_cost = argc > 2 ? std::atoll(argv[2]) : 1;
+    costs.cache_refill = argc > 3 ? std::atoll(argv[3]) : 4;
+    costs.cache_lifetime = argc > 4 ? std::atoll(argv[4]) : 50;
+    runBenchmark(std::atoi(argv[1]), costs);
+    return 0;
+}
@@ -0,0 +1,301 @@
+// File: timeline.h
+// Execution timeline for the lab 4 scheduler.
+//
+// Every stretch a process spends on a CPU (and every migration between
+// CPUs or switch overhead paid) becomes one fixed-size 16-byte
+// TimelineEvent. Each simulated CPU records into its own preallocated ring,
+// so recording is a store and an increment with no allocation, formatting
+// or locking. When a ring fills it is either written out in one block to a
+// binary timeline file or, with no file, overwritten so that the most
+// recent events are kept.
+//
+// Binary timeline files are the 8-byte magic "SCHDTL01" followed by raw
+// little-endian TimelineEvents. Blocks from different CPUs are interleaved,
+// so events are grouped by CPU rather than globally sorted by time.
+// ChromeTraceWriter turns events into the JSON that chrome://tracing and
+// Perfetto load, one time unit per microsecond and one track per CPU.
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+const char TIMELINE_MAGIC[8] = {'S', 'C', 'H', 'D', 'T', 'L', '0', '1'};
+
+enum TimelineKind : uint8_t {
+    TIMELINE_COMPLETED = 0,   // the process finished
+    TIMELINE_EXPIRED = 1,     // its slice ran out
+    TIMELINE_PREEMPTED = 2,   // a more deserving process took the CPU
+    TIMELINE_MIGRATION = 3,   // moved to this CPU; duration is the migration cost
+    TIMELINE_SWITCH = 4,      // switch overhead and cache refill before the process ran
+};
+
+inline const char* timelineKindName(uint8_t kind) {
+    switch (kind) {
+        case TIMELINE_COMPLETED: return "completed";
+        case TIMELINE_EXPIRED: return "expired";
+        case TIMELINE_PREEMPTED: return "preempted";
+        case TIMELINE_MIGRATION: return "migration";
+        case TIMELINE_SWITCH: return "switch";
+    }
+    return "?";
+}
+
+struct TimelineEvent {
+    int32_t start;
+    int32_t duration;
+    int32_t pid;
+    uint16_t cpu;
+    uint8_t kind;
+    uint8_t reserved;
+};
+
+static_assert(sizeof(TimelineEvent) == 16, "timeline events are written to disk as is");
+
+class Timeline;
+
+// One CPU's events. Only the thread simulating that CPU records into it.
+class TimelineRing {
+private:
+    Timeline& owner;
+    std::vector<TimelineEvent> events;
+    size_t mask;
+    unsigned long long head = 0;      // events recorded so far
+    unsigned long long written = 0;   // events already handed to the file
+
+    void spill();
+
+    friend class Timeline;
+
+public:
+    TimelineRing(Timeline& timeline, size_t capacity)
+        : owner(timeline), events(capacity), mask(capacity - 1) {}
+
+    void record(int32_t start, int32_t duration, int32_t pid, uint16_t cpu, uint8_t kind) {
+        events[head & mask] = {start, duration, pid, cpu, kind, 0};
+        if (++head - written == events.size()) spill();
+    }
+};
+
+class Timeline {
+private:
+    size_t capacity;
+    std::FILE* out = nullptr;
+    std::mutex file_mutex;
+    std::vector<std::unique_ptr<TimelineRing>> rings;
+    bool write_failed = false;
+
+    friend class TimelineRing;
+
+    // Called from the simulation threads, so failures are only noted here
+    // and reported by close().
+    void writeBlock(const TimelineEvent* first, size_t n) {
+        std::lock_guard<std::mutex> lock(file_mutex);
+        if (n && std::fwrite(first, sizeof(TimelineEvent), n, out) != n) write_failed = true;
+    }
+
+    // Unwritten events of a ring, oldest first, as at most two runs.
+    template <typename Fn>
+    static void forPending(const TimelineRing& ring, Fn fn) {
+        unsigned long long from = std::max(ring.written, ring.head > ring.events.size() ? ring.head - ring.events.size() : 0);
+        size_t begin = static_cast<size_t>(from & ring.mask);
+        size_t n = static_cast<size_t>(ring.head - from);
+        size_t first = std::min(n, ring.events.size() - begin);
+        fn(ring.events.data() + begin, first);
+        fn(ring.events.data(), n - first);
+    }
+
+public:
+    // capacity is per CPU and rounded up to a power of two. With a path,
+    // full rings are written there; otherwise only the latest events stay.
+    explicit Timeline(size_t events_per_cpu = 1 << 16, const std::string& path = "") {
+        capacity = 1;
+        while (capacity < std::max<size_t>(events_per_cpu, 2)) capacity <<= 1;
+        if (!path.empty()) {
+            out = std::fopen(path.c_str(), "wb");
+            if (!out) throw std::runtime_error("cannot create " + path);
+            std::fwrite(TIMELINE_MAGIC, 1, sizeof(TIMELINE_MAGIC), out);
+        }
+    }
+
+    Timeline(const Timeline&) = delete;
+    Timeline& operator=(const Timeline&) = delete;
+
+    ~Timeline() {
+        if (out) std::fclose(out);
+    }
+
+    // Rings must be created before the CPUs start running on their threads.
+    TimelineRing& ring(int cpu) {
+        while (static_cast<int>(rings.size()) <= cpu) {
+            rings.emplace_back(new TimelineRing(*this, capacity));
+        }
+        return *rings[cpu];
+    }
+
+    unsigned long long recorded() const {
+        unsigned long long total = 0;
+        for (const auto& r : rings) total += r->head;
+        return total;
+    }
+
+    // Events overwritten before anyone saw them (only without a file).
+    unsigned long long dropped() const {
+        unsigned long long total = 0;
+        for (const auto& r : rings) {
+            if (r->head - r->written > r->events.size()) total += r->head - r->written - r->events.size();
+        }
+        return total;
+    }
+
+    // Writes whatever the rings still hold and closes the file.
+    void close() {
+        if (!out) return;
+        for (auto& r : rings) {
+            forPending(*r, [this](const TimelineEvent* first, size_t n) { writeBlock(first, n); });
+            r->written = r->head;
+        }
+        int status = std::fclose(out);
+        out = nullptr;
+        if (status != 0 || write_failed) throw std::runtime_error("writing timeline failed");
+    }
+
+    // Events still held in the rings, sorted by start time.
+    std::vector<TimelineEvent> events() const {
+        std::vector<TimelineEvent> all;
+        for (const auto& r : rings) {
+            forPending(*r, [&all](const TimelineEvent* first, size_t n) { all.insert(all.end(), first, first + n); });
+        }
+        std::stable_sort(all.begin(), all.end(), [](const TimelineEvent& a, const TimelineEvent& b) {
+            return a.start < b.start;
+        });
+        return all;
+    }
+};
+
+inline void TimelineRing::spill() {
+    if (!owner.out) return;   // no file: keep overwriting the oldest events
+    owner.writeBlock(events.data(), events.size());
+    written = head;
+}
+
+// Streams events out as Chrome trace JSON through one large buffer.
+class ChromeTraceWriter {
+private:
+    std::FILE* out;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool first = true;
+    int max_cpu = -1;
+
+    void put(const char* text, size_t n) {
+        if (used + n > buffer.size()) drain();
+        std::memcpy(buffer.data() + used, text, n);
+        used += n;
+    }
+
+    void put(const char* text) { put(text, std::strlen(text)); }
+
+    void put(long long value) {
+        char digits[24];
+        char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        put(digits, static_cast<size_t>(end - digits));
+    }
+
+    void drain() {
+        if (used && std::fwrite(buffer.data(), 1, used, out) != used) {
+            throw std::runtime_error("writing Chrome trace failed");
+        }
+        used = 0;
+    }
+
+    void separator() {
+        put(first ? "\n" : ",\n");
+        first = false;
+    }
+
+public:
+    explicit ChromeTraceWriter(const std::string& path) : buffer(1 << 20) {
+        out = std::fopen(path.c_str(), "wb");
+        if (!out) throw std::runtime_error("cannot create " + path);
+        put("{\"traceEvents\":[");
+    }
+
+    ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+    ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+
+    ~ChromeTraceWriter() {
+        if (out) std::fclose(out);
+    }
+
+    void write(const TimelineEvent* events, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            const TimelineEvent& e = events[i];
+            separator();
+            put(e.kind == TIMELINE_MIGRATION ? "{\"name\":\"migrate P"
+                : e.kind == TIMELINE_SWITCH ? "{\"name\":\"switch to P" : "{\"name\":\"P");
+            put(e.pid);
+            put("\",\"ph\":\"X\",\"pid\":0,\"tid\":");
+            put(e.cpu);
+            put(",\"ts\":");
+            put(e.start);
+            put(",\"dur\":");
+            put(e.duration);
+            put(",\"args\":{\"end\":\"");
+            put(timelineKindName(e.kind));
+            put("\"}}");
+            max_cpu = std::max<int>(max_cpu, e.cpu);
+        }
+    }
+
+    void close() {
+        for (int cpu = 0; cpu <= max_cpu; ++cpu) {
+            separator();
+            put("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":");
+            put(cpu);
+            put(",\"args\":{\"name\":\"CPU ");
+            put(cpu);
+            put("\"}}");
+        }
+        put("\n]}\n");
+        drain();
+        int status = std::fclose(out);
+        out = nullptr;
+        if (status != 0) throw std::runtime_error("closing Chrome trace failed");
+    }
+};
+
+// Converts a binary timeline file to Chrome trace JSON, a block at a time.
+// Returns the number of events converted.
+inline unsigned long long convertTimeline(const std::string& in_path, const std::string& out_path) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> in(std::fopen(in_path.c_str(), "rb"), std::fclose);
+    if (!in) throw std::runtime_error("cannot open " + in_path);
+
+    char magic[sizeof(TIMELINE_MAGIC)];
+    if (std::fread(magic, 1, sizeof(magic), in.get()) != sizeof(magic)
+        || std::memcmp(magic, TIMELINE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(in_path + " is not a timeline file");
+    }
+
+    ChromeTraceWriter writer(out_path);
+    std::vector<TimelineEvent> block(1 << 16);
+    unsigned long long total = 0;
+    size_t n;
+    while ((n = std::fread(block.data(), sizeof(TimelineEvent), block.size(), in.get())) > 0) {
+        writer.write(block.data(), n);
+        total += n;
+    }
+    writer.close();
+    return total;
+}
+
+#endif // TIMELINE_H
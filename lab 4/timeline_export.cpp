@@ -0,0 +1,127 @@
+// File: timeline_export.cpp
+// Compile: g++ -O2 -pthread -o timeline_export timeline_export.cpp -std=c++17
+// Usage:   ./timeline_export                   (Gantt chart of the textbook example)
+//          ./timeline_export <processes> [policy] [quantum] [cpus] [prefix]
+//          policy: fcfs, sjf, srtf, priority, priority-preemptive, rr, mlfq, cfs, edf, rm (default rr)
+//
+// The second form records the timeline of a random workload to
+// <prefix>.bin (default "timeline") and converts it to <prefix>.json, which
+// chrome://tracing or https://ui.perfetto.dev can open.
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <sys/stat.h>
+
+#include "scheduler.h"
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+long long fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<long long>(st.st_size) : 0;
+}
+
+void runExample() {
+    ProcessScheduler scheduler;
+    scheduler.addProcess(1, 0, 7, 3);
+    scheduler.addProcess(2, 2, 4, 1);
+    scheduler.addProcess(3, 4, 1, 4);
+    scheduler.addProcess(4, 5, 4, 2);
+
+    // No file: the ring just keeps the events in memory.
+    Timeline timeline(64);
+    scheduler.options.timeline = &timeline;
+    scheduler.run(SchedulingPolicy::ROUND_ROBIN, 2);
+
+    std::cout << "Round Robin (quantum 2) timeline\n";
+    std::cout << "================================\n";
+    std::cout << std::setw(7) << "Start" << std::setw(7) << "End" << std::setw(6) << "PID" << "  Ends because\n";
+    for (const TimelineEvent& e : timeline.events()) {
+        std::cout << std::setw(7) << e.start << std::setw(7) << e.start + e.duration
+                  << std::setw(6) << e.pid << "  " << timelineKindName(e.kind) << "\n";
+    }
+
+    std::cout << "\nGantt: ";
+    for (const TimelineEvent& e : timeline.events()) {
+        std::cout << "|" << std::string(e.duration, static_cast<char>('0' + e.pid % 10));
+    }
+    std::cout << "|\n";
+}
+
+int runExport(int count, SchedulingPolicy policy, int quantum, int cpus, const std::string& prefix) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> gap(0, 40 / std::max(1, cpus));
+    std::uniform_int_distribution<> burst(1, 60);
+    std::uniform_int_distribution<> prio(0, 31);
+
+    ProcessTable workload;
+    workload.reserve(count);
+    int arrival = 0;
+    for (int i = 0; i < count; ++i) {
+        arrival += gap(gen);
+        workload.add(i + 1, arrival, burst(gen), prio(gen));
+    }
+
+    std::string bin_path = prefix + ".bin";
+    std::string json_path = prefix + ".json";
+
+    try {
+        ProcessScheduler plain;
+        plain.table = workload;
+        plain.options.multicore.cpus = cpus;
+        auto start = std::chrono::steady_clock::now();
+        plain.run(policy, quantum);
+        double plain_time = secondsSince(start);
+
+        ProcessScheduler traced;
+        traced.table = workload;
+        traced.options.multicore.cpus = cpus;
+        Timeline timeline(1 << 16, bin_path);
+        traced.options.timeline = &timeline;
+        start = std::chrono::steady_clock::now();
+        traced.run(policy, quantum);
+        timeline.close();
+        double traced_time = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        unsigned long long converted = convertTimeline(bin_path, json_path);
+        double convert_time = secondsSince(start);
+
+        std::cout << policyName(policy) << " on " << cpus << " CPU(s), " << count << " processes\n";
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "Simulation without timeline: " << plain_time << " s\n";
+        std::cout << "Simulation with timeline:    " << traced_time << " s, "
+                  << timeline.recorded() << " events ("
+                  << std::setprecision(1) << (traced_time - plain_time) * 1e9 / std::max(1ULL, timeline.recorded())
+                  << " ns/event)\n";
+        std::cout << "Binary timeline: " << bin_path << ", " << fileSize(bin_path) / 1024 << " KB\n";
+        std::cout << "Chrome trace:    " << json_path << ", " << fileSize(json_path) / 1024 << " KB, "
+                  << converted << " events in " << std::setprecision(3) << convert_time << " s\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        runExample();
+        return 0;
+    }
+
+    SchedulingPolicy policy = SchedulingPolicy::ROUND_ROBIN;
+    if (argc > 2 && !parsePolicy(argv[2], policy)) {
+        std::cerr << "Error: unknown policy " << argv[2] << std::endl;
+        return 1;
+    }
+    int quantum = argc > 3 ? std::atoi(argv[3]) : 4;
+    int cpus = argc > 4 ? std::atoi(argv[4]) : 1;
+    std::string prefix = argc > 5 ? argv[5] : "timeline";
+    return runExport(std::atoi(argv[1]), policy, quantum, cpus, prefix);
+}
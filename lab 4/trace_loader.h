@@ -0,0 +1,462 @@
+// File: trace_loader.h
+// Streaming workload traces for the lab 4 scheduler.
+//
+// Two on-disk formats are understood:
+//   CSV     one "pid,arrival,burst[,priority]" line per process. Lines that
+//           do not start with a number (headers, '#' comments) are skipped.
+//   Binary  the 8-byte magic "SCHDTRC1" followed by one varint-coded record
+//           per process: zigzag(pid delta), arrival delta, burst,
+//           zigzag(priority). Most records fit in 4-6 bytes.
+//
+// Traces must be sorted by arrival time. Files are mmap'd and parsed in
+// place without building a std::string per line, pages that have been
+// consumed are dropped from the mapping, and the scheduler pulls processes
+// in batches, so memory use does not grow with the length of the trace.
+
+#ifndef TRACE_LOADER_H
+#define TRACE_LOADER_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "process.h"
+#include "metrics.h"
+#include "scheduler.h"
+
+const char BINARY_TRACE_MAGIC[8] = {'S', 'C', 'H', 'D', 'T', 'R', 'C', '1'};
+
+//=============================================================================
+// MEMORY-MAPPED INPUT
+//=============================================================================
+
+class MappedFile {
+private:
+    int fd = -1;
+    const char* bytes = nullptr;
+    size_t length = 0;
+    size_t released = 0;
+
+    static constexpr size_t RELEASE_CHUNK = 64 << 20;
+
+public:
+    explicit MappedFile(const std::string& path) {
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open " + path);
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) return;
+
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("cannot mmap " + path);
+        }
+        bytes = static_cast<const char*>(mapped);
+        madvise(mapped, length, MADV_SEQUENTIAL);
+    }
+
+    MappedFile(MappedFile&& other) noexcept
+        : fd(other.fd), bytes(other.bytes), length(other.length), released(other.released) {
+        other.fd = -1;
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    ~MappedFile() {
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+        if (fd >= 0) close(fd);
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+    // Lets the kernel drop already-parsed pages so a long trace does not
+    // stay resident behind the read position.
+    void consumedUpTo(size_t offset) {
+        if (offset < released + RELEASE_CHUNK) return;
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t end = offset / page * page;
+        madvise(const_cast<char*>(bytes) + released, end - released, MADV_DONTNEED);
+        released = end;
+    }
+};
+
+//=============================================================================
+// TRACE READERS
+//=============================================================================
+
+class TraceReader {
+public:
+    virtual ~TraceReader() = default;
+
+    // Clears batch and appends up to max_rows processes to it.
+    // Returns false once the trace is exhausted.
+    virtual bool next(ProcessTable& batch, size_t max_rows) = 0;
+
+protected:
+    // Times are ints (see TIME_LIMIT). On one CPU, and ignoring switch
+    // costs, a run ends by the latest arrival plus all the work, so a trace
+    // is accepted only while that bound fits.
+    bool fitsTimeRange(int arrival, int burst) {
+        latest_arrival = std::max<long long>(latest_arrival, arrival);
+        total_burst += burst;
+        return latest_arrival + total_burst <= TIME_LIMIT;
+    }
+
+private:
+    long long latest_arrival = 0;
+    long long total_burst = 0;
+};
+
+class CsvTraceReader : public TraceReader {
+private:
+    MappedFile file;
+    size_t pos = 0;
+    size_t line = 0;
+
+    static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static void skipBlanks(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    }
+
+    static bool parseInt(const char*& p, const char* end, int& out) {
+        skipBlanks(p, end);
+        bool negative = p < end && *p == '-';
+        if (negative) ++p;
+        if (p == end || !isDigit(*p)) return false;
+
+        long long value = 0;
+        while (p < end && isDigit(*p)) {
+            value = value * 10 + (*p++ - '0');
+            if (value > INT_MAX) return false;
+        }
+        out = static_cast<int>(negative ? -value : value);
+        skipBlanks(p, end);
+        if (p < end && *p == ',') ++p;
+        return true;
+    }
+
+    [[noreturn]] void malformed() const {
+        throw std::runtime_error("malformed CSV trace at line " + std::to_string(line));
+    }
+
+public:
+    explicit CsvTraceReader(MappedFile&& mapped) : file(std::move(mapped)) {}
+
+    bool next(ProcessTable& batch, size_t max_rows) override {
+        batch.clear();
+        const char* base = file.data();
+        const char* end = base + file.size();
+
+        while (batch.size() < max_rows && pos < file.size()) {
+            const char* p = base + pos;
+            const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (!eol) eol = end;
+            ++line;
+            pos = static_cast<size_t>(eol - base) + 1;
+
+            skipBlanks(p, eol);
+            if (p == eol || !(isDigit(*p) || *p == '-')) continue;
+
+            int pid, arrival, burst, priority = 0;
+            if (!parseInt(p, eol, pid) || !parseInt(p, eol, arrival) || !parseInt(p, eol, burst)) malformed();
+            if (p < eol && !parseInt(p, eol, priority)) malformed();
+            if (p != eol) malformed();
+            if (arrival < 0 || burst < 0) malformed();
+            if (!fitsTimeRange(arrival, burst)) {
+                throw std::runtime_error("CSV trace runs past the int time range at line " + std::to_string(line));
+            }
+            batch.add(pid, arrival, burst, priority);
+        }
+
+        file.consumedUpTo(pos);
+        return !batch.empty();
+    }
+};
+
+class BinaryTraceReader : public TraceReader {
+private:
+    MappedFile file;
+    size_t pos = sizeof(BINARY_TRACE_MAGIC);
+    int prev_pid = 0;
+    long long prev_arrival = 0;
+
+    unsigned long long readVarint() {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(file.data());
+        unsigned long long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos == file.size()) throw std::runtime_error("truncated binary trace");
+            unsigned char byte = p[pos++];
+            value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("corrupt varint in binary trace");
+    }
+
+    static long long unzigzag(unsigned long long v) {
+        return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+    }
+
+public:
+    explicit BinaryTraceReader(MappedFile&& mapped) : file(std::move(mapped)) {}
+
+    bool next(ProcessTable& batch, size_t max_rows) override {
+        batch.clear();
+        while (batch.size() < max_rows && pos < file.size()) {
+            int pid = static_cast<int>(prev_pid + unzigzag(readVarint()));
+            unsigned long long arrival_delta = readVarint();
+            unsigned long long raw_burst = readVarint();
+            int priority = static_cast<int>(unzigzag(readVarint()));
+            if (arrival_delta > static_cast<unsigned long long>(INT_MAX - prev_arrival)) {
+                throw std::runtime_error("arrival time overflow in binary trace");
+            }
+            if (raw_burst > INT_MAX) throw std::runtime_error("burst time overflow in binary trace");
+            long long arrival = prev_arrival + static_cast<long long>(arrival_delta);
+            int burst = static_cast<int>(raw_burst);
+            if (!fitsTimeRange(static_cast<int>(arrival), burst)) {
+                throw std::runtime_error("binary trace runs past the int time range");
+            }
+
+            batch.add(pid, static_cast<int>(arrival), burst, priority);
+            prev_pid = pid;
+            prev_arrival = arrival;
+        }
+
+        file.consumedUpTo(pos);
+        return !batch.empty();
+    }
+};
+
+// Picks the reader from the file contents: binary traces start with the
+// magic, anything else is parsed as CSV.
+inline std::unique_ptr<TraceReader> openTrace(const std::string& path) {
+    MappedFile file(path);
+    if (file.size() >= sizeof(BINARY_TRACE_MAGIC)
+        && std::memcmp(file.data(), BINARY_TRACE_MAGIC, sizeof(BINARY_TRACE_MAGIC)) == 0) {
+        return std::unique_ptr<TraceReader>(new BinaryTraceReader(std::move(file)));
+    }
+    return std::unique_ptr<TraceReader>(new CsvTraceReader(std::move(file)));
+}
+
+// Reads a whole trace into memory, for callers that replay it many times.
+inline ProcessTable loadTrace(const std::string& path) {
+    std::unique_ptr<TraceReader> reader = openTrace(path);
+    ProcessTable table, batch;
+    while (reader->next(batch, 65536)) {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            table.add(batch.pid[i], batch.arrival_time[i], batch.burst_time[i], batch.priority[i]);
+        }
+    }
+    return table;
+}
+
+//=============================================================================
+// BINARY TRACE WRITER
+//=============================================================================
+
+class BinaryTraceWriter {
+private:
+    FILE* out;
+    std::vector<unsigned char> buffer;
+    int prev_pid = 0;
+    long long prev_arrival = 0;
+
+    void putVarint(unsigned long long v) {
+        while (v >= 0x80) {
+            buffer.push_back(static_cast<unsigned char>(v | 0x80));
+            v >>= 7;
+        }
+        buffer.push_back(static_cast<unsigned char>(v));
+    }
+
+    static unsigned long long zigzag(long long v) {
+        return (static_cast<unsigned long long>(v) << 1) ^ static_cast<unsigned long long>(v >> 63);
+    }
+
+    void drain() {
+        if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), out) != buffer.size()) {
+            throw std::runtime_error("write to binary trace failed");
+        }
+        buffer.clear();
+    }
+
+public:
+    explicit BinaryTraceWriter(const std::string& path) {
+        out = std::fopen(path.c_str(), "wb");
+        if (!out) throw std::runtime_error("cannot create " + path);
+        buffer.reserve(1 << 20);
+        buffer.insert(buffer.end(), BINARY_TRACE_MAGIC, BINARY_TRACE_MAGIC + sizeof(BINARY_TRACE_MAGIC));
+    }
+
+    BinaryTraceWriter(const BinaryTraceWriter&) = delete;
+    BinaryTraceWriter& operator=(const BinaryTraceWriter&) = delete;
+
+    ~BinaryTraceWriter() {
+        if (out) {
+            std::fwrite(buffer.data(), 1, buffer.size(), out);
+            std::fclose(out);
+        }
+    }
+
+    void write(int pid, int arrival, int burst, int priority = 0) {
+        if (arrival < prev_arrival) throw std::runtime_error("binary traces must be sorted by arrival time");
+        if (burst < 0) throw std::runtime_error("negative burst time in binary trace");
+        putVarint(zigzag(static_cast<long long>(pid) - prev_pid));
+        putVarint(static_cast<unsigned long long>(arrival - prev_arrival));
+        putVarint(static_cast<unsigned int>(burst));
+        putVarint(zigzag(priority));
+        prev_pid = pid;
+        prev_arrival = arrival;
+        if (buffer.size() >= (1 << 20)) drain();
+    }
+
+    void close() {
+        drain();
+        if (std::fclose(out) != 0) {
+            out = nullptr;
+            throw std::runtime_error("closing binary trace failed");
+        }
+        out = nullptr;
+    }
+};
+
+//=============================================================================
+// STREAMING WORKLOAD
+//=============================================================================
+
+// Feeds the event engine straight from a TraceReader. Only processes that
+// have arrived but not yet completed occupy a slot; completed slots are
+// recycled, and their results are folded into a MetricsCalculator in small
+// chunks instead of being kept.
+class StreamWorkload {
+private:
+    TraceReader& reader;
+    MetricsCalculator& metrics;
+    size_t batch_rows;
+
+    ProcessTable slots;
+    ScheduleResult slot_results;
+    std::vector<int> free_slots;
+
+    ProcessTable batch;
+    size_t batch_pos = 0;
+    int last_arrival = INT_MIN;
+    long long arrived = 0;
+
+    std::vector<int> done_completion, done_turnaround, done_waiting, done_response;
+    static constexpr size_t FLUSH_ROWS = 4096;
+
+    int allocateSlot() {
+        if (!free_slots.empty()) {
+            int slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+        slots.add(0, 0, 0, 0);
+        slot_results.remaining_time.push_back(0);
+        slot_results.completion_time.push_back(0);
+        slot_results.turnaround_time.push_back(0);
+        slot_results.waiting_time.push_back(0);
+        slot_results.response_time.push_back(-1);
+        return static_cast<int>(slots.size()) - 1;
+    }
+
+public:
+    StreamWorkload(TraceReader& r, MetricsCalculator& m, size_t rows_per_batch = 65536)
+        : reader(r), metrics(m), batch_rows(rows_per_batch) {
+        done_completion.reserve(FLUSH_ROWS);
+        done_turnaround.reserve(FLUSH_ROWS);
+        done_waiting.reserve(FLUSH_ROWS);
+        done_response.reserve(FLUSH_ROWS);
+    }
+
+    const ProcessTable& table() const { return slots; }
+    ScheduleResult& result() { return slot_results; }
+
+    bool nextArrival(int& slot) {
+        if (batch_pos == batch.size()) {
+            if (!reader.next(batch, batch_rows)) return false;
+            batch_pos = 0;
+        }
+
+        size_t row = batch_pos++;
+        if (batch.arrival_time[row] < last_arrival) {
+            throw std::runtime_error("trace is not sorted by arrival time (pid "
+                                     + std::to_string(batch.pid[row]) + ")");
+        }
+        last_arrival = batch.arrival_time[row];
+        ++arrived;
+
+        slot = allocateSlot();
+        slots.pid[slot] = batch.pid[row];
+        slots.arrival_time[slot] = batch.arrival_time[row];
+        slots.burst_time[slot] = batch.burst_time[row];
+        slots.priority[slot] = batch.priority[row];
+        slots.deadline[slot] = batch.deadline[row];
+        slots.period[slot] = batch.period[row];
+        slot_results.remaining_time[slot] = batch.burst_time[row];
+        slot_results.response_time[slot] = -1;
+        return true;
+    }
+
+    void complete(int slot) {
+        done_completion.push_back(slot_results.completion_time[slot]);
+        done_turnaround.push_back(slot_results.turnaround_time[slot]);
+        done_waiting.push_back(slot_results.waiting_time[slot]);
+        done_response.push_back(slot_results.response_time[slot]);
+        if (done_completion.size() == FLUSH_ROWS) flush();
+        free_slots.push_back(slot);
+    }
+
+    void flush() {
+        metrics.addResults(done_completion.data(), done_turnaround.data(), done_waiting.data(),
+                           done_response.data(), done_completion.size());
+        done_completion.clear();
+        done_turnaround.clear();
+        done_waiting.clear();
+        done_response.clear();
+    }
+
+    long long processCount() const { return arrived; }
+    size_t peakSlots() const { return slots.size(); }
+};
+
+// Streams a whole trace through the scheduler; results go into metrics.
+inline SimulationStats simulateTrace(TraceReader& reader, SchedulingPolicy policy, int quantum,
+                                     MetricsCalculator& metrics, size_t* peak_slots = nullptr,
+                                     const PolicyOptions& options = PolicyOptions()) {
+    metrics.reset();
+    StreamWorkload workload(reader, metrics);
+    SimulationStats stats = simulatePolicy(workload, policy, quantum, options);
+    workload.flush();
+    metrics.setCPUIdleTime(stats.idle_time);
+    metrics.setSwitchOverhead(stats.switch_overhead);
+    metrics.setLevelLatency(stats.level_latency);
+    metrics.setCoreUsage(stats.cpu_busy_time, stats.cpu_migrations);
+    metrics.setDeadlineStats(stats.deadline_jobs, stats.deadline_misses, stats.max_lateness);
+    if (peak_slots) *peak_slots = workload.peakSlots();
+    return stats;
+}
+
+#endif // TRACE_LOADER_H
@@ -0,0 +1,259 @@
+// File: vruntime_tree.h
+// Red-black tree keyed by virtual runtime, used by the CFS ready queue.
+//
+// Nodes come from a pool: one vector of nodes plus a free list, addressed by
+// int index, so inserting a runnable task never calls the allocator once the
+// pool has grown to the number of tasks in flight. Index 0 is the shared
+// black nil sentinel (as in CLRS). The leftmost node is cached so the CFS
+// pick-next is O(1); insert and erase are O(log n).
+
+#ifndef VRUNTIME_TREE_H
+#define VRUNTIME_TREE_H
+
+#include <vector>
+#include <cstddef>
+
+class VruntimeTree {
+private:
+    struct Node {
+        long long key;
+        unsigned long long seq;   // insertion order, breaks ties between equal keys
+        int value;
+        int left, right, parent;
+        bool red;
+    };
+
+    std::vector<Node> pool;
+    std::vector<int> free_nodes;
+    int root = 0;
+    int leftmost = 0;
+    size_t count = 0;
+    unsigned long long next_seq = 0;
+
+    bool less(int a, int b) const {
+        const Node& x = pool[a];
+        const Node& y = pool[b];
+        return x.key != y.key ? x.key < y.key : x.seq < y.seq;
+    }
+
+    int allocate(long long key, int value) {
+        int id;
+        if (!free_nodes.empty()) {
+            id = free_nodes.back();
+            free_nodes.pop_back();
+        } else {
+            id = static_cast<int>(pool.size());
+            pool.push_back(Node());
+        }
+        pool[id] = {key, next_seq++, value, 0, 0, 0, true};
+        return id;
+    }
+
+    int minimum(int x) const {
+        while (pool[x].left != 0) x = pool[x].left;
+        return x;
+    }
+
+    void rotateLeft(int x) {
+        int y = pool[x].right;
+        pool[x].right = pool[y].left;
+        if (pool[y].left != 0) pool[pool[y].left].parent = x;
+        pool[y].parent = pool[x].parent;
+        if (pool[x].parent == 0) root = y;
+        else if (x == pool[pool[x].parent].left) pool[pool[x].parent].left = y;
+        else pool[pool[x].parent].right = y;
+        pool[y].left = x;
+        pool[x].parent = y;
+    }
+
+    void rotateRight(int x) {
+        int y = pool[x].left;
+        pool[x].left = pool[y].right;
+        if (pool[y].right != 0) pool[pool[y].right].parent = x;
+        pool[y].parent = pool[x].parent;
+        if (pool[x].parent == 0) root = y;
+        else if (x == pool[pool[x].parent].right) pool[pool[x].parent].right = y;
+        else pool[pool[x].parent].left = y;
+        pool[y].right = x;
+        pool[x].parent = y;
+    }
+
+    void insertFixup(int z) {
+        while (pool[pool[z].parent].red) {
+            int p = pool[z].parent;
+            int g = pool[p].parent;
+            if (p == pool[g].left) {
+                int uncle = pool[g].right;
+                if (pool[uncle].red) {
+                    pool[p].red = pool[uncle].red = false;
+                    pool[g].red = true;
+                    z = g;
+                } else {
+                    if (z == pool[p].right) {
+                        z = p;
+                        rotateLeft(z);
+                        p = pool[z].parent;
+                    }
+                    pool[p].red = false;
+                    pool[g].red = true;
+                    rotateRight(g);
+                }
+            } else {
+                int uncle = pool[g].left;
+                if (pool[uncle].red) {
+                    pool[p].red = pool[uncle].red = false;
+                    pool[g].red = true;
+                    z = g;
+                } else {
+                    if (z == pool[p].left) {
+                        z = p;
+                        rotateRight(z);
+                        p = pool[z].parent;
+                    }
+                    pool[p].red = false;
+                    pool[g].red = true;
+                    rotateLeft(g);
+                }
+            }
+        }
+        pool[root].red = false;
+    }
+
+    void transplant(int u, int v) {
+        if (pool[u].parent == 0) root = v;
+        else if (u == pool[pool[u].parent].left) pool[pool[u].parent].left = v;
+        else pool[pool[u].parent].right = v;
+        pool[v].parent = pool[u].parent;
+    }
+
+    void eraseFixup(int x) {
+        while (x != root && !pool[x].red) {
+            int p = pool[x].parent;
+            if (x == pool[p].left) {
+                int w = pool[p].right;
+                if (pool[w].red) {
+                    pool[w].red = false;
+                    pool[p].red = true;
+                    rotateLeft(p);
+                    w = pool[p].right;
+                }
+                if (!pool[pool[w].left].red && !pool[pool[w].right].red) {
+                    pool[w].red = true;
+                    x = p;
+                } else {
+                    if (!pool[pool[w].right].red) {
+                        pool[pool[w].left].red = false;
+                        pool[w].red = true;
+                        rotateRight(w);
+                        w = pool[p].right;
+                    }
+                    pool[w].red = pool[p].red;
+                    pool[p].red = false;
+                    pool[pool[w].right].red = false;
+                    rotateLeft(p);
+                    x = root;
+                }
+            } else {
+                int w = pool[p].left;
+                if (pool[w].red) {
+                    pool[w].red = false;
+                    pool[p].red = true;
+                    rotateRight(p);
+                    w = pool[p].left;
+                }
+                if (!pool[pool[w].right].red && !pool[pool[w].left].red) {
+                    pool[w].red = true;
+                    x = p;
+                } else {
+                    if (!pool[pool[w].left].red) {
+                        pool[pool[w].right].red = false;
+                        pool[w].red = true;
+                        rotateLeft(w);
+                        w = pool[p].left;
+                    }
+                    pool[w].red = pool[p].red;
+                    pool[p].red = false;
+                    pool[pool[w].left].red = false;
+                    rotateRight(p);
+                    x = root;
+                }
+            }
+        }
+        pool[x].red = false;
+    }
+
+public:
+    VruntimeTree() {
+        pool.push_back({0, 0, -1, 0, 0, 0, false});
+    }
+
+    void reserve(size_t n) { pool.reserve(n + 1); }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Node handles stay valid until that node is erased.
+    int first() const { return leftmost; }
+    long long key(int node) const { return pool[node].key; }
+    int value(int node) const { return pool[node].value; }
+
+    int insert(long long key, int value) {
+        int z = allocate(key, value);
+        int parent = 0;
+        int x = root;
+        while (x != 0) {
+            parent = x;
+            x = less(z, x) ? pool[x].left : pool[x].right;
+        }
+        pool[z].parent = parent;
+        if (parent == 0) root = z;
+        else if (less(z, parent)) pool[parent].left = z;
+        else pool[parent].right = z;
+
+        if (leftmost == 0 || less(z, leftmost)) leftmost = z;
+        ++count;
+        insertFixup(z);
+        return z;
+    }
+
+    void erase(int z) {
+        if (z == leftmost) {
+            // The leftmost node has no left child, so its successor is the
+            // minimum of its right subtree or, failing that, its parent.
+            leftmost = pool[z].right != 0 ? minimum(pool[z].right) : pool[z].parent;
+        }
+
+        int y = z;
+        bool y_was_red = pool[y].red;
+        int x;
+        if (pool[z].left == 0) {
+            x = pool[z].right;
+            transplant(z, pool[z].right);
+        } else if (pool[z].right == 0) {
+            x = pool[z].left;
+            transplant(z, pool[z].left);
+        } else {
+            y = minimum(pool[z].right);
+            y_was_red = pool[y].red;
+            x = pool[y].right;
+            if (pool[y].parent == z) {
+                pool[x].parent = y;
+            } else {
+                transplant(y, pool[y].right);
+                pool[y].right = pool[z].right;
+                pool[pool[y].right].parent = y;
+            }
+            transplant(z, y);
+            pool[y].left = pool[z].left;
+            pool[pool[y].left].parent = y;
+            pool[y].red = pool[z].red;
+        }
+        if (!y_was_red) eraseFixup(x);
+
+        pool[0].parent = 0;
+        free_nodes.push_back(z);
+        --count;
+    }
+};
+
+#endif // VRUNTIME_TREE_H